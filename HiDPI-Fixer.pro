@@ -20,71 +20,30 @@
 # THE SOFTWARE.
 #
 
-#-------------------------------------------------------------------------------
-# Project configuration
-#-------------------------------------------------------------------------------
-
-TEMPLATE = app
-TARGET = HiDPI-Fixer
 
 #-------------------------------------------------------------------------------
-# Import Qt modules
+# Project configuration
 #-------------------------------------------------------------------------------
 
-QT += gui
-QT += core
-QT += widgets
+TEMPLATE = subdirs
 
 #-------------------------------------------------------------------------------
-# Deploy config
+# Import sub-projects
 #-------------------------------------------------------------------------------
 
-linux:!android {
-    QT += x11extras
+# GUI-free library with the xrandr bridge, layout and script generation code
+core.subdir = src/core
 
-    target.path = /usr/bin
-    icon.path = /usr/share/pixmaps
-    desktop.path = /usr/share/applications
-    icon.files += $$PWD/deploy/linux/hidpi-fixer.png
-    desktop.files += $$PWD/deploy/linux/hidpi-fixer.desktop
-
-    TARGET = hidpi-fixer
-    INSTALLS += target desktop icon
-}
-
-#-------------------------------------------------------------------------------
-# Make options
-#-------------------------------------------------------------------------------
+# Qt Widgets application
+app.subdir = src/app
+app.depends = core
 
-UI_DIR = uic
-MOC_DIR = moc
-RCC_DIR = qrc
-OBJECTS_DIR = obj
+# Command line interface (QtCore only)
+cli.subdir = src/cli
+cli.depends = core
 
-CONFIG += c++17
-
-#-------------------------------------------------------------------------------
-# Import source code
-#-------------------------------------------------------------------------------
-
-SOURCES += \
-    $$PWD/src/main.cpp \
-    $$PWD/src/MainWindow.cpp \
-    $$PWD/src/StartupVerifications.cpp \
-    $$PWD/src/XRandrBridge.cpp
-
-HEADERS += \
-    $$PWD/src/MainWindow.h \
-    $$PWD/src/Global.h \
-    $$PWD/src/StartupVerifications.h \
-    $$PWD/src/XRandrBridge.h
-
-FORMS += \
-    $$PWD/src/MainWindow.ui
-    
-#-------------------------------------------------------------------------------
-# Import resources
-#-------------------------------------------------------------------------------
+# Unit tests (run with "make check")
+tests.subdir = tests
+tests.depends = core
 
-RESOURCES += \
-    $$PWD/images/images.qrc
+SUBDIRS += core app cli tests
@@ -0,0 +1,757 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QLabel>
+#include <QTimer>
+#include <QDebug>
+#include <QProcess>
+#include <QListWidget>
+#include <QMessageBox>
+#include <QVBoxLayout>
+#include <QApplication>
+#include <QStandardPaths>
+#include <QDialogButtonBox>
+#include <QDesktopServices>
+
+#include "Global.h"
+#include "Preflight.h"
+#include "MainWindow.h"
+#include "ScriptFile.h"
+#include "DisplayLayout.h"
+#include "SessionHook.h"
+#include "DesktopIndex.h"
+#include "ProfileStore.h"
+#include "DisplaySnapshot.h"
+
+#include "ui_MainWindow.h"
+
+MainWindow::MainWindow(QWidget *parent)
+    : QMainWindow(parent)
+{
+    // Generate UI components
+    ui = new Ui::MainWindow;
+    ui->setupUi(this);
+
+    // Set monospace font and min. size for script preview
+    QFont font;
+    font.setPixelSize(10);
+    font.setFamily("Monospace");
+    ui->ScriptPreview->setFont(font);
+    ui->ScriptPreview->setMinimumWidth(390);
+    ui->ScriptPreview->setMinimumHeight(120);
+
+    // Resize window to minimum size
+    resize(0, 0);
+    setMinimumSize(size());
+    setMaximumSize(size());
+    setWindowFlags(Qt::WindowCloseButtonHint);
+
+    // Set window title
+    setWindowTitle(qApp->applicationName() + " " + qApp->applicationVersion());
+
+    // Connect signals/slots
+    connect(ui->QuitMenu, SIGNAL(triggered()), this, SLOT(close()));
+    connect(ui->CloseButton, SIGNAL(clicked()), this, SLOT(close()));
+    connect(ui->DisplaysCombo, SIGNAL(currentIndexChanged(int)), this,
+            SLOT(updateResolutionCombo(int)));
+    connect(ui->ScaleFactor, SIGNAL(valueChanged(double)), this,
+            SLOT(generateScript(double)));
+    connect(ui->XrandrScale, SIGNAL(toggled(bool)), this, SLOT(updateScript(bool)));
+    connect(ui->TextDpiScale, SIGNAL(toggled(bool)), this, SLOT(updateScript(bool)));
+    connect(ui->CombineDisplays, SIGNAL(toggled(bool)), this, SLOT(updateScript(bool)));
+    connect(ui->XprofileHook, SIGNAL(toggled(bool)), this, SLOT(updateScript(bool)));
+    connect(ui->ScriptPreview, SIGNAL(textChanged()), this,
+            SLOT(updateScriptExecControls()));
+    connect(ui->ResolutionsComboBox, SIGNAL(currentIndexChanged(int)), this,
+            SLOT(updateScript(int)));
+    connect(ui->DisplaysCombo, SIGNAL(currentIndexChanged(int)), this,
+            SLOT(updateScript(int)));
+    connect(ui->TestButton, SIGNAL(clicked()), this, SLOT(testScript()));
+    connect(ui->SaveScriptButton, SIGNAL(clicked()), this, SLOT(saveScript()));
+    connect(ui->SaveScriptMenu, SIGNAL(triggered()), this, SLOT(saveScript()));
+    connect(ui->RevertMenu, SIGNAL(triggered()), this, SLOT(revertChanges()));
+    connect(ui->ScaleAppsMenu, SIGNAL(triggered()), this, SLOT(scaleApplications()));
+    connect(ui->ReportBugMenu, SIGNAL(triggered()), this, SLOT(reportBugs()));
+    connect(ui->AboutQtMenu, SIGNAL(triggered()), qApp, SLOT(aboutQt()));
+
+    // Get outputs, modes and screen limits (used to validate the display layout)
+    m_backend = BackendCreate(QString(), QString());
+    if (!m_backend)
+    {
+        QMessageBox::warning(this, tr("Error"),
+                             tr("Cannot load the display session set in "
+                                "HIDPI_FIXER_BACKEND, using the native backend."));
+        m_backend = BackendCreate("native", QString());
+    }
+
+    if (!m_backend->inventory(m_inventory))
+        qWarning() << Q_FUNC_INFO << m_backend->errorString();
+    m_maxFramebuffer = m_inventory.maximum;
+
+    // Populate controls
+    ui->ScriptPreview->setPlainText("");
+    ui->AppName->setText(qApp->applicationName());
+    const QList<OutputInfo> outputs = InventoryConnectedOutputs(m_inventory);
+    for (int i = 0; i < outputs.count(); ++i)
+        ui->DisplaysCombo->addItem(outputs.at(i).name);
+
+    // Only watch for changes if they may switch profiles (several display
+    // topologies or a power-saving variant) or if the watcher is installed
+    bool watch = SessionAutostartList().contains("watch");
+    ProfileStore store(PROFILES_HOME);
+    if (store.load())
+    {
+        const QList<ProfileInfo> profiles = store.profiles();
+        watch |= profiles.count() > 1;
+        for (int i = 0; i < profiles.count(); ++i)
+            watch |= profiles.at(i).powerSaving;
+    }
+    ui->WatchProfiles->setChecked(watch);
+
+    // Warn user if we cannot get the display list
+    if (ui->DisplaysCombo->count() == 0)
+    {
+        QMessageBox::warning(this, tr("Error"),
+                             tr("Cannot get the list of displays, please check "
+                                "that xrandr is installed and working."));
+    }
+}
+
+/**
+ * Deletes the UI components when the window is destroyed
+ */
+MainWindow::~MainWindow()
+{
+    // Delete test script
+    QFile file(SCRIPTS_HOME + "/test");
+    if (file.exists())
+        file.remove();
+
+    // De-allocate UI memory
+    if (ui != nullptr)
+        delete ui;
+
+    // Close display backend
+    delete m_backend;
+}
+
+/**
+ * Saves the script as the profile of the connected displays, modifies the
+ * .profile file (for Qt apps) and registers the profile switch on login and
+ * the profile watcher (if enabled, or needed by the power-saving variant).
+ */
+void MainWindow::saveScript()
+{
+    // Create script specific to the selected display (or to the whole layout)
+    QString dispName = ui->DisplaysCombo->currentText();
+    if (ui->CombineDisplays->isChecked())
+        dispName = "layout";
+
+    QString scriptPath = QString("%1/scripts/%2").arg(SCRIPTS_HOME).arg(dispName);
+
+    // There was an error saving (or running the script)
+    if (saveAndExecuteScript(scriptPath) != 0)
+    {
+        qWarning() << Q_FUNC_INFO << "Error while saving/running" << scriptPath;
+        return;
+    }
+
+    // The profile always covers every connected display, so that saving the
+    // script of another display does not replace the previous one
+    const bool textDpi = ui->TextDpiScale->isChecked();
+    const bool xrandrScale = ui->XrandrScale->isChecked();
+    const bool preDesktop = ui->XprofileHook->isChecked();
+    const DisplayLayout layout = profileLayout();
+    const QStringList errors
+        = textDpi ? PreflightValidate(LayoutNative(layout), m_inventory, true)
+                  : PreflightValidate(layout, m_inventory, xrandrScale);
+    if (!errors.isEmpty())
+    {
+        QMessageBox::warning(this, tr("Error"),
+                             tr("The profile of the connected displays cannot be "
+                                "applied:\n%1")
+                                 .arg(errors.join('\n')));
+        return;
+    }
+
+    QString script = ui->ScriptPreview->document()->toPlainText();
+    if (!ui->CombineDisplays->isChecked())
+        script = textDpi ? LayoutGenerateTextDpiScript(layout, preDesktop)
+                         : LayoutGenerateScript(layout, xrandrScale, preDesktop);
+
+    // Use the same layout without the oversized framebuffer on battery
+    QString powerSavingScript;
+    if (ui->PowerSavingVariant->isChecked() && !textDpi)
+        powerSavingScript = LayoutGenerateTextDpiScript(layout, preDesktop);
+
+    // Register script as the profile of the connected displays (which is
+    // what runs on login)
+    ProfileStore store(PROFILES_HOME);
+    if (!store.load()
+        || !store.insert(ProfileDescribe(m_inventory), script, powerSavingScript))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot save profile in" << PROFILES_HOME;
+        QMessageBox::warning(this, tr("Error"),
+                             tr("Cannot save the profile in \"%1\"!").arg(PROFILES_HOME));
+        return;
+    }
+
+    // Export the per-display factors of Qt and GTK apps
+    if (ui->FixQtDpiCheckbox->isChecked())
+    {
+        QStringList outputs;
+        const QList<OutputInfo> connected = InventoryConnectedOutputs(m_inventory);
+        for (int i = 0; i < connected.count(); ++i)
+            outputs.append(connected.at(i).name);
+
+        const QStringList exports
+            = LayoutGetToolkitEnvironment(layout, outputs, textDpi);
+        if (!SessionEnvironmentInstall(exports))
+        {
+            qWarning() << Q_FUNC_INFO << "Cannot edit" << SHELL_PROFILE_LOCATION;
+            QMessageBox::warning(
+                this, tr("Error"),
+                tr("Cannot open \"%1\" for editing!").arg(SHELL_PROFILE_LOCATION));
+        }
+    }
+
+    // Apply the variant of the profile that suits the power source whenever
+    // the displays or the power source change
+    const bool watch = ui->WatchProfiles->isChecked() || !powerSavingScript.isEmpty();
+    if (watch && !SessionAutostartInstall("watch", "Watch HiDPI Profiles", { "--watch" }))
+    {
+        QMessageBox::warning(
+            this, tr("Error"),
+            tr("Cannot create a launcher in \"%1\"!").arg(AUTOSTART_LOCATION));
+        return;
+    }
+
+    // Apply the profile of the connected displays when the session starts,
+    // either from ~/.xprofile (before the desktop loads) or from an autostart
+    // launcher, older launchers of the displays covered by the profile and
+    // hooks are removed to avoid applying the changes twice
+    QStringList keep = SessionAutostartList();
+    for (int i = 0; i < layout.displays.count(); ++i)
+        keep.removeAll(layout.displays.at(i).name);
+    if (layout.complete)
+        keep.removeAll("layout");
+    if (!watch)
+        keep.removeAll("watch");
+
+    const QStringList switchArguments { "--switch", "auto" };
+    if (preDesktop)
+    {
+        keep.removeAll("profile");
+        SessionAutostartRemove(keep);
+        if (!SessionHookInstall(switchArguments))
+        {
+            QMessageBox::warning(
+                this, tr("Error"),
+                tr("Cannot open \"%1\" for editing!").arg(XPROFILE_LOCATION));
+            return;
+        }
+    }
+
+    else
+    {
+        SessionHookRemove();
+        SessionAutostartRemove(keep);
+        if (!SessionAutostartInstall("profile", "Apply HiDPI Profile", switchArguments))
+        {
+            QMessageBox::warning(
+                this, tr("Error"),
+                tr("Cannot create a launcher in \"%1\"!").arg(AUTOSTART_LOCATION));
+            return;
+        }
+    }
+
+    // Notify user
+    QMessageBox::information(this, tr("Info"),
+                             tr("Changes applied, its recommended to "
+                                "logout and login again to test that "
+                                "the script works as intended."));
+}
+
+/**
+ * Saves the current script to the test script location and
+ * executes the script.
+ */
+void MainWindow::testScript()
+{
+    if (saveAndExecuteScript(SCRIPTS_HOME + "/test") == 0 && !confirmChanges())
+        revertChanges();
+}
+
+/**
+ * Restores the display state saved before the last test or apply
+ */
+void MainWindow::revertChanges()
+{
+    // Nothing to revert
+    if (!QFile::exists(REVERT_SCRIPT))
+    {
+        QMessageBox::warning(this, tr("Error"),
+                             tr("No display state has been saved yet!"));
+        return;
+    }
+
+    // Run revert script
+    if (QProcess::execute("bash", { REVERT_SCRIPT }) != 0)
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot execute" << REVERT_SCRIPT;
+        QMessageBox::warning(this, tr("Error"),
+                             tr("Cannot run script at %1").arg(REVERT_SCRIPT));
+    }
+}
+
+/**
+ * Lets the user select the applications that ignore every scaling setting,
+ * and creates launchers that run them through run_scaled (or removes the
+ * launchers of the applications that are no longer selected)
+ */
+void MainWindow::scaleApplications()
+{
+    // run_scaled is needed by the launchers
+    if (QStandardPaths::findExecutable(RUN_SCALED).isEmpty())
+    {
+        QMessageBox::warning(this, tr("Error"),
+                             tr("Cannot find \"%1\", please install it from "
+                                "https://github.com/kaueraal/run_scaled")
+                                 .arg(RUN_SCALED));
+        return;
+    }
+
+    // Update the application index (only new or modified files are parsed,
+    // the launchers created below are picked up by the next update)
+    DesktopIndex index(APPLICATIONS_INDEX);
+    index.load();
+    index.update(DesktopGetApplicationDirs());
+    index.save();
+
+    // Create application list, apps with a launcher are checked
+    QDialog dialog(this);
+    QListWidget *list = new QListWidget(&dialog);
+    const QSet<QString> launchers = index.launchers();
+    const QList<DesktopEntry> apps = index.applications();
+    for (int i = 0; i < apps.count(); ++i)
+    {
+        const QIcon icon = QIcon::fromTheme(apps.at(i).icon);
+        QListWidgetItem *item = new QListWidgetItem(icon, apps.at(i).name, list);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(launchers.contains(apps.at(i).id) ? Qt::Checked
+                                                              : Qt::Unchecked);
+    }
+
+    // Create dialog
+    QDialogButtonBox *buttons
+        = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, SIGNAL(accepted()), &dialog, SLOT(accept()));
+    connect(buttons, SIGNAL(rejected()), &dialog, SLOT(reject()));
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    layout->addWidget(new QLabel(tr("Select the applications that do not scale:")));
+    layout->addWidget(list);
+    layout->addWidget(buttons);
+    dialog.setWindowTitle(tr("Scale Applications"));
+    dialog.resize(420, 480);
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+
+    // Apps are drawn at the GNOME factor, unless only the text is scaled
+    qreal scale = m_layout.factor;
+    if (ui->TextDpiScale->isChecked())
+        scale = ui->ScaleFactor->value();
+
+    // Create or remove launchers
+    QStringList errors;
+    for (int i = 0; i < apps.count(); ++i)
+    {
+        const DesktopEntry &app = apps.at(i);
+        const bool checked = list->item(i)->checkState() == Qt::Checked;
+        if (checked && !LauncherInstall(app, scale))
+            errors.append(LauncherPath(app.id));
+        else if (!checked && launchers.contains(app.id) && !LauncherRemove(app.id))
+            errors.append(LauncherPath(app.id));
+    }
+
+    // Notify user
+    if (!errors.isEmpty())
+        QMessageBox::warning(this, tr("Error"),
+                             tr("Cannot create or remove the following launchers:\n%1")
+                                 .arg(errors.join('\n')));
+}
+
+/**
+ * Opens the GitHub issues page
+ */
+void MainWindow::reportBugs()
+{
+    QDesktopServices::openUrl(QUrl("https://github.com/alex-spataru"
+                                   "/HiDPI-Fixer/issues"));
+}
+
+/**
+ * Enables or disables the test script and save script controls
+ * depending if the script is available or not
+ */
+void MainWindow::updateScriptExecControls()
+{
+    // There is not a valid script available, disable test and save buttons
+    QString script = ui->ScriptPreview->document()->toPlainText();
+    if (script.length() == 0 || !m_preflightErrors.isEmpty())
+    {
+        ui->TestButton->setEnabled(false);
+        ui->SaveScriptMenu->setEnabled(false);
+        ui->SaveScriptButton->setEnabled(false);
+    }
+
+    // The script is available, enable controls
+    else
+    {
+        ui->TestButton->setEnabled(true);
+        ui->SaveScriptMenu->setEnabled(true);
+        ui->SaveScriptButton->setEnabled(true);
+    }
+}
+
+/**
+ * Dummy function, used to re-generate the script when the
+ * user changes the display
+ */
+void MainWindow::updateScript(const int unused)
+{
+    (void)unused;
+
+    if (ui->ResolutionsComboBox->count() > 0)
+        generateScript(ui->ScaleFactor->value());
+}
+
+/**
+ * Dummy function, used to re-generate the script when the
+ * user toggles the xrandr --scale or combined layout checkboxes
+ */
+void MainWindow::updateScript(const bool unused)
+{
+    updateScript((int)unused);
+}
+
+/**
+ * Generates a script that uses xrandr to resize the
+ * contents of the screen to the given \a scale
+ */
+void MainWindow::generateScript(const qreal scale)
+{
+    // Check if current selected resolution is valid
+    QStringList size = ui->ResolutionsComboBox->currentText().split("x");
+    if (size.count() != 2)
+    {
+        qWarning() << "Invalid resolution" << ui->ResolutionsComboBox->currentText();
+        QMessageBox::warning(
+            this, tr("Error"),
+            tr("Invalid resolution \"%1\"!").arg(ui->ResolutionsComboBox->currentText()));
+        return;
+    }
+
+    // Register mode and scale selected for the current display
+    DisplayConfig config;
+    config.name = ui->DisplaysCombo->currentText();
+    config.mode.setWidth(size.at(0).toInt());
+    config.mode.setHeight(size.at(1).toInt());
+    config.rotation = outputInfo(config.name).rotation;
+    config.scale = scale;
+    m_configs.insert(config.name, config);
+
+    // Arrange the displays in the smallest possible framebuffer
+    DisplayLayout layout = LayoutCompute(layoutDisplays(config), m_maxFramebuffer);
+    updateCostEstimate(layout);
+
+    // Do not move (or turn off) the displays that are not configured
+    const int connected = InventoryConnectedOutputs(m_inventory).count();
+    layout.complete = layout.displays.count() >= connected;
+    m_layout = layout;
+
+    // The text DPI method keeps the native modes, xrandr --scale is not used
+    const bool textDpi = ui->TextDpiScale->isChecked();
+    ui->XrandrScale->setEnabled(!textDpi);
+    ui->PowerSavingVariant->setEnabled(!textDpi);
+
+    // Reject layouts that the X server or the displays cannot drive
+    if (textDpi)
+        m_preflightErrors = PreflightValidate(LayoutNative(layout), m_inventory, true);
+    else
+        m_preflightErrors
+            = PreflightValidate(layout, m_inventory, ui->XrandrScale->isChecked());
+    if (!m_preflightErrors.isEmpty())
+    {
+        ui->ScriptPreview->clear();
+        ui->ScriptPreview->setPlainText(
+            QString("# Error: this configuration cannot be applied\n# %1\n")
+                .arg(m_preflightErrors.join("\n# ")));
+        return;
+    }
+
+    // Update controls
+    if (textDpi)
+        ui->ScriptPreview->setPlainText(
+            LayoutGenerateTextDpiScript(layout, ui->XprofileHook->isChecked()));
+    else
+        ui->ScriptPreview->setPlainText(LayoutGenerateScript(
+            layout, ui->XrandrScale->isChecked(), ui->XprofileHook->isChecked()));
+}
+
+/**
+ * Returns the displays that should be configured by the generated script,
+ * displays that the user has not configured yet use their preferred mode
+ * and the @a current scale factor.
+ */
+QList<DisplayConfig> MainWindow::layoutDisplays(const DisplayConfig &current)
+{
+    // Only configure the selected display
+    QList<DisplayConfig> displays;
+    if (!ui->CombineDisplays->isChecked())
+    {
+        displays.append(current);
+        return displays;
+    }
+
+    // Configure every display
+    for (int i = 0; i < ui->DisplaysCombo->count(); ++i)
+    {
+        // Use previous configuration for this display
+        QString name = ui->DisplaysCombo->itemText(i);
+        if (m_configs.contains(name))
+        {
+            displays.append(m_configs.value(name));
+            continue;
+        }
+
+        // Get preferred resolution of the display
+        const ModeInfo mode = InventoryPreferredMode(outputInfo(name));
+        if (mode.size.isEmpty())
+            continue;
+
+        // Create default configuration
+        DisplayConfig config;
+        config.name = name;
+        config.mode = mode.size;
+        config.rotation = outputInfo(name).rotation;
+        config.scale = current.scale;
+        m_configs.insert(name, config);
+        displays.append(config);
+    }
+
+    return displays;
+}
+
+/**
+ * Returns the layout saved as the profile of the connected displays, which
+ * covers every display: if the displays are not combined, the ones that have
+ * not been configured yet keep their preferred mode without scaling
+ */
+DisplayLayout MainWindow::profileLayout() const
+{
+    if (ui->CombineDisplays->isChecked())
+        return m_layout;
+
+    QList<DisplayConfig> displays;
+    for (int i = 0; i < ui->DisplaysCombo->count(); ++i)
+    {
+        // Use the configuration of this display
+        const QString name = ui->DisplaysCombo->itemText(i);
+        if (m_configs.contains(name))
+        {
+            displays.append(m_configs.value(name));
+            continue;
+        }
+
+        // Get preferred resolution of the display
+        const OutputInfo output = outputInfo(name);
+        const ModeInfo mode = InventoryPreferredMode(output);
+        if (mode.size.isEmpty())
+            continue;
+
+        DisplayConfig config;
+        config.name = name;
+        config.mode = mode.size;
+        config.rotation = output.rotation;
+        displays.append(config);
+    }
+
+    DisplayLayout layout = LayoutCompute(displays, m_maxFramebuffer);
+    const int connected = InventoryConnectedOutputs(m_inventory).count();
+    layout.complete = layout.displays.count() >= connected;
+    return layout;
+}
+
+/**
+ * Saves the script to the given location (creating the directories if
+ * necessary), makes the new file executable and tries to execute
+ * the newly created script/program.
+ */
+int MainWindow::saveAndExecuteScript(const QString &location)
+{
+    // Get script text
+    QString scriptData = ui->ScriptPreview->document()->toPlainText();
+
+    // Script is empty
+    if (scriptData.isEmpty())
+    {
+        QMessageBox::warning(this, tr("Error"), tr("The script is empty!"));
+        return 1;
+    }
+
+    // Configuration did not pass the preflight checks
+    if (!m_preflightErrors.isEmpty())
+    {
+        QMessageBox::warning(this, tr("Error"), m_preflightErrors.join("\n"));
+        return 1;
+    }
+
+    // Save script to file (and make it executable)
+    if (!ScriptSave(location, scriptData))
+    {
+        QMessageBox::warning(this, tr("Error"),
+                             tr("Cannot open %1 for writing!").arg(location));
+        return 1;
+    }
+
+    // Save the current display state, so that the changes can be reverted
+    DisplaySnapshot snapshot;
+    if (!SnapshotCapture(m_backend, snapshot)
+        || !SnapshotSaveRevertScript(snapshot, REVERT_SCRIPT))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot save display state"
+                   << m_backend->errorString();
+        QMessageBox::warning(this, tr("Error"),
+                             tr("Cannot save the current display state!"));
+        return 1;
+    }
+
+    // Run file
+    if (QProcess::execute(location) != 0)
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot execute" << location;
+        QMessageBox::warning(this, tr("Error"),
+                             tr("Cannot run script at %1").arg(location));
+        return 1;
+    }
+
+    // Notify caller that everything is OK
+    return 0;
+}
+
+/**
+ * Updates the resolutions ComboBox when the user selects
+ * another display
+ */
+void MainWindow::updateResolutionCombo(const int index)
+{
+    // Re-populate resolutions (the script is re-generated afterwards)
+    ui->ResolutionsComboBox->blockSignals(true);
+    ui->ResolutionsComboBox->clear();
+    QString name = ui->DisplaysCombo->itemText(index);
+    ui->ResolutionsComboBox->addItems(InventoryResolutions(outputInfo(name)));
+
+    // Restore the mode and scale previously chosen for this display
+    if (m_configs.contains(name))
+    {
+        const DisplayConfig config = m_configs.value(name);
+        QString mode
+            = QString("%1x%2").arg(config.mode.width()).arg(config.mode.height());
+        int modeIndex = ui->ResolutionsComboBox->findText(mode);
+        if (modeIndex >= 0)
+            ui->ResolutionsComboBox->setCurrentIndex(modeIndex);
+
+        ui->ScaleFactor->blockSignals(true);
+        ui->ScaleFactor->setValue(config.scale);
+        ui->ScaleFactor->blockSignals(false);
+    }
+
+    ui->ResolutionsComboBox->blockSignals(false);
+}
+
+/**
+ * Returns the information of the output with the given @a name
+ */
+OutputInfo MainWindow::outputInfo(const QString &name) const
+{
+    for (int i = 0; i < m_inventory.outputs.count(); ++i)
+    {
+        if (m_inventory.outputs.at(i).name == name)
+            return m_inventory.outputs.at(i);
+    }
+
+    return OutputInfo();
+}
+
+/**
+ * Shows the framebuffer memory and the pixels drawn per frame needed by each
+ * scaling method for the given @a layout
+ */
+void MainWindow::updateCostEstimate(const DisplayLayout &layout)
+{
+    const LayoutCost mode = LayoutEstimateCost(layout, false);
+    const LayoutCost scale = LayoutEstimateCost(layout, true);
+    const LayoutCost text = LayoutEstimateCost(LayoutNative(layout), false);
+
+    const qreal mb = 1024 * 1024;
+    const qreal mpx = 1000 * 1000;
+    ui->CostEstimate->setText(
+        tr("Framebuffer: %1 MB (new resolution), %2 MB (--scale), %3 MB (text)\n"
+           "Pixels per frame: %4 M (new resolution), %5 M (--scale), %6 M (text)")
+            .arg(mode.framebufferBytes / mb, 0, 'f', 1)
+            .arg(scale.framebufferBytes / mb, 0, 'f', 1)
+            .arg(text.framebufferBytes / mb, 0, 'f', 1)
+            .arg(mode.framePixels / mpx, 0, 'f', 1)
+            .arg(scale.framePixels / mpx, 0, 'f', 1)
+            .arg(text.framePixels / mpx, 0, 'f', 1));
+}
+
+/**
+ * Asks the user to keep the tested changes, returns @c false if the user
+ * chooses to revert them or does not answer before the timeout
+ */
+bool MainWindow::confirmChanges()
+{
+    // Create dialog
+    int remaining = REVERT_TIMEOUT;
+    const QString text = tr("Do you want to keep these display settings?\n"
+                            "Reverting in %1 seconds...");
+    QMessageBox box(QMessageBox::Question, tr("Keep changes?"), text.arg(remaining),
+                    QMessageBox::NoButton, this);
+    QPushButton *keep = box.addButton(tr("Keep changes"), QMessageBox::AcceptRole);
+    box.addButton(tr("Revert"), QMessageBox::RejectRole);
+
+    // Update countdown every second, close dialog when it reaches zero
+    QTimer timer;
+    timer.setInterval(1000);
+    connect(&timer, &QTimer::timeout, &box, [&]() {
+        if (--remaining <= 0)
+            box.reject();
+        else
+            box.setText(text.arg(remaining));
+    });
+
+    // Show dialog
+    timer.start();
+    box.exec();
+    return box.clickedButton() == keep;
+}
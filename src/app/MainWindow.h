@@ -23,9 +23,13 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QMap>
 #include <QMainWindow>
 #include <QApplication>
 
+#include "DisplayLayout.h"
+#include "DisplayBackend.h"
+
 namespace Ui
 {
 class MainWindow;
@@ -43,6 +47,8 @@ private slots:
     void saveScript();
     void testScript();
     void reportBugs();
+    void revertChanges();
+    void scaleApplications();
     void updateScriptExecControls();
     void updateScript(const int unused);
     void updateScript(const bool unused);
@@ -51,9 +57,20 @@ private slots:
 
 private:
     int saveAndExecuteScript(const QString &location);
+    QList<DisplayConfig> layoutDisplays(const DisplayConfig &current);
+    DisplayLayout profileLayout() const;
+    OutputInfo outputInfo(const QString &name) const;
+    void updateCostEstimate(const DisplayLayout &layout);
+    bool confirmChanges();
 
 private:
     Ui::MainWindow *ui;
+    QSize m_maxFramebuffer;
+    DisplayLayout m_layout;
+    DisplayBackend *m_backend;
+    ScreenInventory m_inventory;
+    QStringList m_preflightErrors;
+    QMap<QString, DisplayConfig> m_configs;
 };
 
 #endif
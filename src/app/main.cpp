@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QMessageBox>
+#include <QCoreApplication>
+
+#ifdef Q_OS_LINUX
+#    include <QX11Info>
+#endif
+
+#include "Global.h"
+#include "MainWindow.h"
+#include "StartupVerifications.h"
+
+/**
+ * Warns the user if the application is not running on a GNU/Linux system
+ * with an X11 display server.
+ *
+ * \returns \c false if the GUI should not be executed
+ */
+static bool CheckPlatform()
+{
+    // Check if we are running on GNU/Linux
+#ifndef Q_OS_LINUX
+    QMessageBox::warning(Q_NULLPTR, QObject::tr("Warning"),
+                         QObject::tr("This application is intended for Linux "
+                                     "distributions only!"));
+    return false;
+#else
+    // Check that an XServer is running
+    if (!QX11Info::isPlatformX11())
+    {
+        QMessageBox::warning(Q_NULLPTR, QObject::tr("Warning"),
+                             QObject::tr("You are not running this application "
+                                         "on an X11 instance!"));
+    }
+
+    return true;
+#endif
+}
+
+/**
+ * Main entry point of the application
+ *
+ * \param argc Argument count
+ * \param argv Argument data
+ */
+int main(int argc, char **argv)
+{
+    // Handle command line options without loading the GUI
+    if (argc > 1)
+    {
+        QCoreApplication app(argc, argv);
+        app.setApplicationName(APP_NAME);
+        app.setApplicationVersion(APP_VERSION);
+
+        int exitCode = EXIT_SUCCESS;
+        if (!StartupVerifications(argc, argv, exitCode))
+            return exitCode;
+    }
+
+    // Create GUI application
+    QApplication app(argc, argv);
+    app.setApplicationName(APP_NAME);
+    app.setApplicationVersion(APP_VERSION);
+
+    // Check platform and show main window
+    if (CheckPlatform())
+    {
+        MainWindow window;
+        window.show();
+
+        return app.exec();
+    }
+
+    return EXIT_SUCCESS;
+}
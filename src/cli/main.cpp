@@ -20,29 +20,31 @@
  * THE SOFTWARE.
  */
 
+#include <QCoreApplication>
+
 #include "Global.h"
-#include "MainWindow.h"
 #include "StartupVerifications.h"
 
 /**
- * Main entry point of the application
+ * Main entry point of the command line interface, which only depends on
+ * QtCore and never loads the GUI.
  *
  * \param argc Argument count
  * \param argv Argument data
  */
 int main(int argc, char **argv)
 {
-    QApplication app(argc, argv);
+    QCoreApplication app(argc, argv);
     app.setApplicationName(APP_NAME);
     app.setApplicationVersion(APP_VERSION);
 
-    if (StartupVerifications(argc, argv))
+    // No arguments or invalid arguments, show available options
+    int exitCode = EXIT_SUCCESS;
+    if (StartupVerifications(argc, argv, exitCode))
     {
-        MainWindow window;
-        window.show();
-
-        return app.exec();
+        StartupShowHelp();
+        return EXIT_FAILURE;
     }
 
-    return EXIT_SUCCESS;
+    return exitCode;
 }
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Cvt.h"
+
+/*
+ * Constants of the VESA Coordinated Video Timings standard, with the same
+ * values used by the X server (and thus by the cvt utility).
+ */
+static const int CVT_H_GRANULARITY = 8;
+static const int CVT_MIN_V_PORCH = 3;
+static const int CVT_CLOCK_STEP = 250;
+static const int CVT_HSYNC_PERCENTAGE = 8;
+static const float CVT_MIN_VSYNC_BP = 550.0;
+static const int CVT_M_PRIME = 600 * 128 / 256;
+static const int CVT_C_PRIME = (40 - 20) * 128 / 256 + 20;
+
+/**
+ * Returns the width @a w rounded up to a multiple of the CVT character cell,
+ * which is the width of the mode that the cvt utility creates
+ */
+int CvtRoundWidth(const int w)
+{
+    const int remainder = w % CVT_H_GRANULARITY;
+    return remainder ? w + CVT_H_GRANULARITY - remainder : w;
+}
+
+/**
+ * Calculates the (non-reduced blanking) CVT timings for a mode with a width
+ * of @a w, a height of @a h and a vertical refresh rate of @a refresh Hz.
+ *
+ * This is a port of the algorithm used by the cvt utility, so that modelines
+ * can be generated without spawning a process for each one of them.
+ */
+CvtTimings CvtComputeTimings(const int w, const int h, const qreal refresh)
+{
+    Q_ASSERT(w > 0);
+    Q_ASSERT(h > 0);
+
+    // Use 60 Hz by default
+    const float fieldRate = refresh > 0 ? static_cast<float>(refresh) : 60;
+
+    // Horizontal pixels must be a multiple of the character cell
+    CvtTimings mode;
+    mode.hDisplay = CvtRoundWidth(w);
+    mode.vDisplay = h;
+
+    // Get vertical sync width from the aspect ratio
+    int vSync = 10;
+    if (!(h % 3) && ((h * 4 / 3) == w))
+        vSync = 4;
+    else if (!(h % 9) && ((h * 16 / 9) == w))
+        vSync = 5;
+    else if (!(h % 10) && ((h * 16 / 10) == w))
+        vSync = 6;
+    else if (!(h % 4) && ((h * 5 / 4) == w))
+        vSync = 7;
+    else if (!(h % 9) && ((h * 15 / 9) == w))
+        vSync = 7;
+
+    // Estimate horizontal period
+    const float hPeriod = static_cast<float>(1000000.0 / fieldRate - CVT_MIN_VSYNC_BP)
+        / (mode.vDisplay + CVT_MIN_V_PORCH);
+
+    // Get number of lines in sync + back porch
+    int vSyncAndBackPorch = static_cast<int>(CVT_MIN_VSYNC_BP / hPeriod) + 1;
+    if (vSyncAndBackPorch < vSync + CVT_MIN_V_PORCH)
+        vSyncAndBackPorch = vSync + CVT_MIN_V_PORCH;
+
+    // Get total number of lines
+    mode.vTotal = mode.vDisplay + vSyncAndBackPorch + CVT_MIN_V_PORCH;
+
+    // Get ideal blanking duty cycle
+    float hBlankPercentage = CVT_C_PRIME - CVT_M_PRIME * hPeriod / 1000.0;
+    if (hBlankPercentage < 20)
+        hBlankPercentage = 20;
+
+    // Get horizontal blanking time
+    int hBlank = mode.hDisplay * hBlankPercentage / (100.0 - hBlankPercentage);
+    hBlank -= hBlank % (2 * CVT_H_GRANULARITY);
+
+    // Get horizontal totals and sync values
+    mode.hTotal = mode.hDisplay + hBlank;
+    mode.hSyncEnd = mode.hDisplay + hBlank / 2;
+    mode.hSyncStart = mode.hSyncEnd - (mode.hTotal * CVT_HSYNC_PERCENTAGE) / 100;
+    mode.hSyncStart += CVT_H_GRANULARITY - mode.hSyncStart % CVT_H_GRANULARITY;
+
+    // Get vertical sync values
+    mode.vSyncStart = mode.vDisplay + CVT_MIN_V_PORCH;
+    mode.vSyncEnd = mode.vSyncStart + vSync;
+
+    // Get pixel clock (kHz)
+    mode.clock = static_cast<int>(mode.hTotal * 1000.0 / hPeriod);
+    mode.clock -= mode.clock % CVT_CLOCK_STEP;
+
+    // Get actual horizontal and vertical frequencies
+    mode.hSync = static_cast<float>(mode.clock) / static_cast<float>(mode.hTotal);
+    mode.vRefresh = (1000.0 * static_cast<float>(mode.clock))
+        / static_cast<float>(mode.hTotal * mode.vTotal);
+
+    return mode;
+}
+
+/**
+ * Returns the modeline string needed to create a resolution with a width of
+ * @a w, a height of @h and a refresh rate of @a refresh Hz, in the same
+ * format as the cvt utility (without the "Modeline" keyword). Like cvt, the
+ * width is rounded up to a multiple of 8 pixels, also in the mode name.
+ */
+QString CvtGetModeline(const int w, const int h, const qreal refresh)
+{
+    Q_ASSERT(w > 0);
+    Q_ASSERT(h > 0);
+
+    const qreal rate = refresh > 0 ? refresh : 60;
+    const CvtTimings mode = CvtComputeTimings(w, h, rate);
+    return QString::asprintf("\"%dx%d_%.2f\"  %6.2f  %d %d %d %d  %d %d %d %d "
+                             "-hsync +vsync",
+                             mode.hDisplay, h, rate, mode.clock / 1000.0, mode.hDisplay,
+                             mode.hSyncStart, mode.hSyncEnd, mode.hTotal,
+                             mode.vDisplay, mode.vSyncStart, mode.vSyncEnd,
+                             mode.vTotal);
+}
+
+/**
+ * Returns the resolution name/mode for the given @a modeline
+ */
+QString CvtGetResolutionName(const QString modeline)
+{
+    Q_ASSERT(!modeline.isEmpty());
+
+    // Construct resulution name (append to string until two '"' chars are found)
+    QString name;
+    int pos = 0;
+    int quoteCharCount = 0;
+    while (quoteCharCount < 2 && pos < modeline.length())
+    {
+        if (modeline.at(pos) == '"')
+            ++quoteCharCount;
+
+        name.append(modeline.at(pos));
+        ++pos;
+    }
+
+    // Return result
+    return name;
+}
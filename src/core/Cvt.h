@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CVT_H
+#define CVT_H
+
+#include <QString>
+
+/**
+ * Timings of a CVT mode, the pixel clock is given in kHz
+ */
+struct CvtTimings
+{
+    int clock = 0;
+    int hDisplay = 0;
+    int hSyncStart = 0;
+    int hSyncEnd = 0;
+    int hTotal = 0;
+    int vDisplay = 0;
+    int vSyncStart = 0;
+    int vSyncEnd = 0;
+    int vTotal = 0;
+    qreal hSync = 0;
+    qreal vRefresh = 0;
+};
+
+extern int CvtRoundWidth(const int w);
+extern CvtTimings CvtComputeTimings(const int w, const int h, const qreal refresh);
+extern QString CvtGetModeline(const int w, const int h, const qreal refresh);
+extern QString CvtGetResolutionName(const QString modeline);
+
+#endif
@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QDirIterator>
+#include <QJsonDocument>
+
+#include <algorithm>
+
+#include "Global.h"
+#include "DesktopIndex.h"
+
+/**
+ * Creates an index cached in the file at @a path, the cache is not read
+ * until load() is called
+ */
+DesktopIndex::DesktopIndex(const QString &path)
+    : m_path(path)
+{
+}
+
+/**
+ * Reads the cached index, a missing cache is treated as an empty index
+ */
+bool DesktopIndex::load()
+{
+    m_order.clear();
+    m_entries.clear();
+
+    // Nothing to read if the cache does not exist
+    QFile file(m_path);
+    if (!file.exists())
+        return true;
+
+    // Read cache
+    if (!file.open(QFile::ReadOnly))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << "for reading!";
+        return false;
+    }
+    const QJsonObject index = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+
+    // Register each entry
+    const QStringList paths = index.keys();
+    for (int i = 0; i < paths.count(); ++i)
+    {
+        const QJsonObject object = index.value(paths.at(i)).toObject();
+
+        DesktopEntry entry;
+        entry.path = paths.at(i);
+        entry.id = object.value("id").toString();
+        entry.name = object.value("name").toString();
+        entry.exec = object.value("exec").toString();
+        entry.icon = object.value("icon").toString();
+        entry.modified = static_cast<qint64>(object.value("modified").toDouble());
+        entry.visible = object.value("visible").toBool();
+        entry.launcher = object.value("launcher").toBool();
+        m_entries.insert(entry.path, entry);
+    }
+
+    return true;
+}
+
+/**
+ * Writes the index cache
+ */
+bool DesktopIndex::save() const
+{
+    // Create cache
+    QJsonObject index;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+    {
+        QJsonObject object;
+        object.insert("id", it.value().id);
+        object.insert("name", it.value().name);
+        object.insert("exec", it.value().exec);
+        object.insert("icon", it.value().icon);
+        object.insert("modified", static_cast<double>(it.value().modified));
+        object.insert("visible", it.value().visible);
+        object.insert("launcher", it.value().launcher);
+        index.insert(it.key(), object);
+    }
+
+    // Create directory if needed
+    QDir dir(QFileInfo(m_path).absolutePath());
+    if (!dir.exists())
+        dir.mkpath(".");
+
+    // Write cache
+    QFile file(m_path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << "for writing!";
+        return false;
+    }
+    file.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+    file.close();
+    return true;
+}
+
+/**
+ * Brings the index up to date with the .desktop files of the given @a dirs
+ * (sorted by priority). Only the files that are new or whose mtime changed
+ * are parsed, the entries of deleted files are dropped.
+ *
+ * \returns The number of parsed files
+ */
+int DesktopIndex::update(const QStringList &dirs)
+{
+    int parsed = 0;
+    QStringList order;
+    QHash<QString, DesktopEntry> entries;
+    for (int i = 0; i < dirs.count(); ++i)
+    {
+        // Desktop file IDs include the subdirectories (with '-' separators)
+        const QDir root(dirs.at(i));
+        QDirIterator it(dirs.at(i), QStringList("*.desktop"), QDir::Files,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext())
+        {
+            const QString path = it.next();
+            if (entries.contains(path))
+                continue;
+
+            // Reuse the cached entry if the file did not change
+            const qint64 modified = it.fileInfo().lastModified().toMSecsSinceEpoch();
+            DesktopEntry entry = m_entries.value(path);
+            if (entry.path.isEmpty() || entry.modified != modified)
+            {
+                entry = DesktopEntry();
+                entry.path = path;
+                entry.modified = modified;
+                entry.id = root.relativeFilePath(path).replace('/', '-');
+                if (!DesktopParse(path, entry))
+                    entry.visible = false;
+
+                ++parsed;
+            }
+
+            order.append(path);
+            entries.insert(path, entry);
+        }
+    }
+
+    m_order = order;
+    m_entries = entries;
+    return parsed;
+}
+
+/**
+ * Returns the applications shown in the menus, sorted by name. If several
+ * files have the same ID, only the one with the highest priority is used
+ * (ignoring the launchers created by HiDPI Fixer, which replace the
+ * original entries).
+ */
+QList<DesktopEntry> DesktopIndex::applications() const
+{
+    QSet<QString> ids;
+    QList<DesktopEntry> list;
+    for (int i = 0; i < m_order.count(); ++i)
+    {
+        const DesktopEntry entry = m_entries.value(m_order.at(i));
+        if (entry.launcher || ids.contains(entry.id))
+            continue;
+
+        ids.insert(entry.id);
+        if (entry.visible)
+            list.append(entry);
+    }
+
+    std::sort(list.begin(), list.end(), [](const DesktopEntry &a, const DesktopEntry &b) {
+        return a.name.compare(b.name, Qt::CaseInsensitive) < 0;
+    });
+
+    return list;
+}
+
+/**
+ * Returns the IDs of the launchers created by HiDPI Fixer
+ */
+QSet<QString> DesktopIndex::launchers() const
+{
+    QSet<QString> ids;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+    {
+        if (it.value().launcher)
+            ids.insert(it.value().id);
+    }
+
+    return ids;
+}
+
+/**
+ * Returns the application directories of the user and the system, sorted by
+ * priority (as defined by the XDG base directory specification)
+ */
+QStringList DesktopGetApplicationDirs()
+{
+    QString dataDirs = qEnvironmentVariable("XDG_DATA_DIRS");
+    if (dataDirs.isEmpty())
+        dataDirs = "/usr/local/share:/usr/share";
+
+    QStringList dirs;
+    dirs.append(APPLICATIONS_LOCATION);
+    const QStringList list = dataDirs.split(':', Qt::SkipEmptyParts);
+    for (int i = 0; i < list.count(); ++i)
+    {
+        const QString dir = QDir::cleanPath(list.at(i) + "/applications");
+        if (!dirs.contains(dir))
+            dirs.append(dir);
+    }
+
+    return dirs;
+}
+
+/**
+ * Reads the name, command and icon of the .desktop file at @a path. The
+ * entry is only visible if it is an application that is shown in the menus.
+ */
+bool DesktopParse(const QString &path, DesktopEntry &entry)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+        return false;
+
+    // Only read the main group, without localized keys
+    bool mainGroup = false;
+    QString type;
+    const QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+    file.close();
+    for (int i = 0; i < lines.count(); ++i)
+    {
+        const QString line = lines.at(i).trimmed();
+        if (line.startsWith('['))
+        {
+            mainGroup = (line == "[Desktop Entry]");
+            continue;
+        }
+
+        const int separator = line.indexOf('=');
+        if (!mainGroup || separator <= 0)
+            continue;
+
+        const QString key = line.left(separator).trimmed();
+        const QString value = line.mid(separator + 1).trimmed();
+        if (key == "Type")
+            type = value;
+        else if (key == "Name")
+            entry.name = value;
+        else if (key == "Exec")
+            entry.exec = value;
+        else if (key == "Icon")
+            entry.icon = value;
+        else if (key == LAUNCHER_MARKER)
+            entry.launcher = (value == "true");
+        else if ((key == "NoDisplay" || key == "Hidden") && value == "true")
+            entry.visible = false;
+    }
+
+    // Ignore links, directories and entries without a command
+    if (type != "Application" || entry.exec.isEmpty() || entry.name.isEmpty())
+        entry.visible = false;
+
+    return true;
+}
+
+/**
+ * Returns the location of the launcher of the application with the given
+ * @a id, which replaces the entry of the system in the menus
+ */
+QString LauncherPath(const QString &id)
+{
+    return QString("%1/%2").arg(APPLICATIONS_LOCATION).arg(id);
+}
+
+/**
+ * Returns @c true if the file at @a path is a launcher created by HiDPI
+ * Fixer
+ */
+static bool IsLauncher(const QString &path)
+{
+    DesktopEntry entry;
+    return DesktopParse(path, entry) && entry.launcher;
+}
+
+/**
+ * Creates a launcher that runs the application of the given @a entry through
+ * run_scaled, so that apps which ignore every scaling setting are rendered
+ * at @a scale. The launcher is a copy of the original entry (including its
+ * actions) in which every command is wrapped and D-Bus activation disabled.
+ */
+bool LauncherInstall(const DesktopEntry &entry, const qreal scale)
+{
+    // Do not replace entries created by the user
+    const QString path = LauncherPath(entry.id);
+    if (QFile::exists(path) && !IsLauncher(path))
+    {
+        qWarning() << Q_FUNC_INFO << path << "was not created by HiDPI Fixer!";
+        return false;
+    }
+
+    // Read original entry
+    QFile original(entry.path);
+    if (!original.open(QFile::ReadOnly))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << entry.path << "for reading!";
+        return false;
+    }
+    const QStringList lines = QString::fromUtf8(original.readAll()).split('\n');
+    original.close();
+
+    // Wrap commands and mark the launcher
+    QStringList contents;
+    const QString wrapper = QString("%1 --scale=%2 ").arg(RUN_SCALED).arg(scale);
+    for (int i = 0; i < lines.count(); ++i)
+    {
+        const QString &line = lines.at(i);
+        if (line.startsWith("DBusActivatable=") || line.startsWith("TryExec="))
+            continue;
+
+        if (line.startsWith("Exec="))
+            contents.append("Exec=" + wrapper + line.mid(5));
+        else
+            contents.append(line);
+
+        if (line.trimmed() == "[Desktop Entry]")
+            contents.append(LAUNCHER_MARKER + "=true");
+    }
+
+    // Create directory if needed
+    QDir dir(APPLICATIONS_LOCATION);
+    if (!dir.exists())
+        dir.mkpath(".");
+
+    // Write launcher
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << path << "for writing!";
+        return false;
+    }
+    file.write(contents.join('\n').toUtf8());
+    file.close();
+    return true;
+}
+
+/**
+ * Removes the launcher of the application with the given @a id, entries
+ * that were not created by HiDPI Fixer are never removed
+ */
+bool LauncherRemove(const QString &id)
+{
+    const QString path = LauncherPath(id);
+    if (!QFile::exists(path))
+        return true;
+
+    if (!IsLauncher(path))
+        return false;
+
+    return QFile::remove(path);
+}
+
+/**
+ * Removes every launcher created by HiDPI Fixer
+ */
+bool LauncherRemoveAll()
+{
+    bool ok = true;
+    QDirIterator it(APPLICATIONS_LOCATION, QStringList("*.desktop"), QDir::Files,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        const QString path = it.next();
+        if (IsLauncher(path) && !QFile::remove(path))
+            ok = false;
+    }
+
+    return ok;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DESKTOP_INDEX_H
+#define DESKTOP_INDEX_H
+
+#include <QSet>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Application entry (.desktop file) found in one of the XDG application
+ * directories, identified by its desktop file ID (e.g. "org.gnome.Maps.desktop")
+ */
+struct DesktopEntry
+{
+    QString id;
+    QString path;
+    QString name;
+    QString exec;
+    QString icon;
+    qint64 modified = 0;
+    bool visible = true;
+    bool launcher = false;
+};
+
+/**
+ * Index of the .desktop files of the system, cached on disk. Updating the
+ * index only parses the files that were added or modified (according to
+ * their mtime) since the previous update, so that the application list is
+ * available instantly on systems with thousands of entries.
+ */
+class DesktopIndex
+{
+public:
+    DesktopIndex(const QString &path);
+
+    bool load();
+    bool save() const;
+    int update(const QStringList &dirs);
+
+    QList<DesktopEntry> applications() const;
+    QSet<QString> launchers() const;
+
+private:
+    QString m_path;
+    QStringList m_order;
+    QHash<QString, DesktopEntry> m_entries;
+};
+
+extern QStringList DesktopGetApplicationDirs();
+extern bool DesktopParse(const QString &path, DesktopEntry &entry);
+
+extern QString LauncherPath(const QString &id);
+extern bool LauncherInstall(const DesktopEntry &entry, const qreal scale);
+extern bool LauncherRemove(const QString &id);
+extern bool LauncherRemoveAll();
+
+#endif
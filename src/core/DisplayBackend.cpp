@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+#include <QThread>
+
+#include "Preflight.h"
+#include "DisplayBackend.h"
+#include "ReplayBackend.h"
+#include "XrandrNativeBackend.h"
+#include "XrandrProcessBackend.h"
+
+/**
+ * Destroys the backend
+ */
+DisplayBackend::~DisplayBackend() {}
+
+/**
+ * Returns the names of the outputs that have a display connected
+ */
+QStringList DisplayBackend::outputs()
+{
+    QStringList names;
+    ScreenInventory screen;
+    if (inventory(screen))
+    {
+        const QList<OutputInfo> connected = InventoryConnectedOutputs(screen);
+        for (int i = 0; i < connected.count(); ++i)
+            names.append(connected.at(i).name);
+    }
+
+    return names;
+}
+
+/**
+ * Returns the modes supported by the given @a output
+ */
+QList<ModeInfo> DisplayBackend::modes(const QString &output)
+{
+    ScreenInventory screen;
+    if (inventory(screen))
+    {
+        for (int i = 0; i < screen.outputs.count(); ++i)
+        {
+            if (screen.outputs.at(i).name == output)
+                return screen.outputs.at(i).modes;
+        }
+    }
+
+    return QList<ModeInfo>();
+}
+
+/**
+ * Validates the @a layout against the current screen limits and displays,
+ * creates the custom modes that it needs (if any) and applies it
+ */
+bool DisplayBackend::configure(const DisplayLayout &layout, const bool xrandrScale)
+{
+    // Reject the layout before touching the displays
+    ScreenInventory screen;
+    if (!inventory(screen))
+        return false;
+
+    const QStringList errors = PreflightValidate(layout, screen, xrandrScale);
+    if (!errors.isEmpty())
+    {
+        setErrorString(errors.join('\n'));
+        return false;
+    }
+
+    // Create custom modes
+    if (!xrandrScale)
+    {
+        for (int i = 0; i < layout.displays.count(); ++i)
+        {
+            const DisplayConfig &display = layout.displays.at(i);
+            if (!createMode(display.name, LayoutGetModeline(display)))
+                return false;
+        }
+    }
+
+    // Apply the layout
+    return applyLayout(layout, xrandrScale);
+}
+
+/**
+ * Waits up to @a timeout milliseconds for the displays to change. Backends
+ * that cannot be notified of changes just sleep and return @c true, so that
+ * the caller reads the inventory again.
+ */
+bool DisplayBackend::waitForChange(const int timeout)
+{
+    QThread::msleep(static_cast<unsigned long>(timeout));
+    return true;
+}
+
+/**
+ * Returns a description of the last error
+ */
+QString DisplayBackend::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * Changes the description of the last error
+ */
+void DisplayBackend::setErrorString(const QString &error)
+{
+    m_errorString = error;
+}
+
+/**
+ * Creates the live backend for the X @a display, the native RandR backend is
+ * preferred when available
+ */
+static DisplayBackend *CreateLiveBackend(const QString &display)
+{
+    XrandrNativeBackend *backend = new XrandrNativeBackend(display);
+    if (backend->isValid())
+        return backend;
+
+    qWarning() << Q_FUNC_INFO << "Native RandR backend not available, using xrandr";
+    delete backend;
+    return new XrandrProcessBackend(display);
+}
+
+/**
+ * Creates a display backend for the X @a display (empty for $DISPLAY) from
+ * the given @a spec, which may be:
+ *
+ * - "native" or an empty string: native RandR backend (falls back to xrandr)
+ * - "xrandr": runs the xrandr utility
+ * - "record:<file>": uses the native backend and saves all calls to <file>
+ * - "replay:<file>": plays back a session saved with "record:<file>"
+ *
+ * If @a spec is empty, the HIDPI_FIXER_BACKEND environment variable is used.
+ * Returns @c nullptr if the session to replay cannot be loaded.
+ */
+DisplayBackend *BackendCreate(const QString &spec, const QString &display)
+{
+    QString backend = spec;
+    if (backend.isEmpty())
+        backend = qEnvironmentVariable("HIDPI_FIXER_BACKEND");
+
+    if (backend == "xrandr")
+        return new XrandrProcessBackend(display);
+
+    else if (backend.startsWith("replay:"))
+    {
+        ReplayBackend *replay = new ReplayBackend(backend.mid(7));
+        if (replay->isValid())
+            return replay;
+
+        qWarning() << Q_FUNC_INFO << replay->errorString();
+        delete replay;
+        return nullptr;
+    }
+
+    else if (backend.startsWith("record:"))
+        return new RecordingBackend(CreateLiveBackend(display), backend.mid(7));
+
+    else if (!backend.isEmpty() && backend != "native")
+        qWarning() << Q_FUNC_INFO << "Unknown backend" << backend;
+
+    return CreateLiveBackend(display);
+}
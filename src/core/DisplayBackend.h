@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DISPLAY_BACKEND_H
+#define DISPLAY_BACKEND_H
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include "DisplayLayout.h"
+#include "DisplayInventory.h"
+
+/**
+ * Interface used to probe and configure the displays of an X screen, so that
+ * the subprocess, native RandR and record/replay implementations can be
+ * swapped without changing the code that uses them.
+ */
+class DisplayBackend
+{
+public:
+    virtual ~DisplayBackend();
+
+    virtual QString name() const = 0;
+    virtual bool inventory(ScreenInventory &inventory) = 0;
+    virtual bool createMode(const QString &output, const QString &modeline) = 0;
+    virtual bool applyLayout(const DisplayLayout &layout, const bool xrandrScale) = 0;
+    virtual bool setResources(const QMap<QString, QString> &resources) = 0;
+    virtual bool waitForChange(const int timeout);
+
+    QStringList outputs();
+    QList<ModeInfo> modes(const QString &output);
+    bool configure(const DisplayLayout &layout, const bool xrandrScale);
+
+    QString errorString() const;
+
+protected:
+    void setErrorString(const QString &error);
+
+private:
+    QString m_errorString;
+};
+
+extern DisplayBackend *BackendCreate(const QString &spec, const QString &display);
+
+#endif
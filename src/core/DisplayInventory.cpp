@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QRegExp>
+#include <QJsonArray>
+#include <QStringList>
+
+#include "Edid.h"
+#include "DisplayInventory.h"
+
+/**
+ * Parses the output of xrandr --verbose (either obtained from the running
+ * X server or captured on another machine) and returns the screen limits,
+ * outputs, modes and EDIDs that it contains.
+ */
+ScreenInventory InventoryParseXrandrVerbose(const QString &output)
+{
+    // Regular expressions used to parse each kind of line
+    QRegExp screenRx("minimum\\s+([0-9]+)\\s*x\\s*([0-9]+),\\s*current\\s+([0-9]+)"
+                     "\\s*x\\s*([0-9]+),\\s*maximum\\s+([0-9]+)\\s*x\\s*([0-9]+)");
+    QRegExp geometryRx("([0-9]+)x([0-9]+)\\+([0-9]+)\\+([0-9]+)");
+    QRegExp physicalRx("([0-9]+)mm x ([0-9]+)mm");
+    QRegExp modeRx("^  (\\S+) \\((0x[0-9a-fA-F]+)\\)\\s+([0-9.]+)MHz(.*)$");
+    QRegExp sizeRx("^([0-9]+)x([0-9]+)");
+    QRegExp refreshRx("^\\s+v:.*clock\\s+([0-9.]+)Hz");
+    QRegExp rotationRx("\\(0x[0-9a-fA-F]+\\) (normal|left|inverted|right)");
+
+    ScreenInventory inventory;
+    bool readingEdid = false;
+    QByteArray edidHex;
+
+    // Parse each line
+    const QStringList lines = output.split('\n');
+    for (int i = 0; i < lines.count(); ++i)
+    {
+        const QString &line = lines.at(i);
+
+        // Continue reading EDID data (lines indented with two tabs)
+        if (readingEdid)
+        {
+            if (line.startsWith("\t\t"))
+            {
+                edidHex.append(line.trimmed().toLatin1());
+                continue;
+            }
+
+            readingEdid = false;
+            if (!inventory.outputs.isEmpty())
+                inventory.outputs.last().edid = QByteArray::fromHex(edidHex);
+        }
+
+        // Screen information
+        if (line.startsWith("Screen "))
+        {
+            if (screenRx.indexIn(line) != -1)
+            {
+                inventory.minimum
+                    = QSize(screenRx.cap(1).toInt(), screenRx.cap(2).toInt());
+                inventory.current
+                    = QSize(screenRx.cap(3).toInt(), screenRx.cap(4).toInt());
+                inventory.maximum
+                    = QSize(screenRx.cap(5).toInt(), screenRx.cap(6).toInt());
+            }
+        }
+
+        // Output information
+        else if (!line.isEmpty() && !line.at(0).isSpace())
+        {
+            const QStringList tokens = line.split(' ', Qt::SkipEmptyParts);
+            if (tokens.count() < 2)
+                continue;
+
+            OutputInfo info;
+            info.name = tokens.at(0);
+            info.connected = tokens.at(1) == "connected";
+            info.primary = tokens.contains("primary");
+
+            // Get position and size of the output (if enabled)
+            if (geometryRx.indexIn(line) != -1)
+            {
+                info.geometry
+                    = QRect(geometryRx.cap(3).toInt(), geometryRx.cap(4).toInt(),
+                            geometryRx.cap(1).toInt(), geometryRx.cap(2).toInt());
+            }
+
+            // Get rotation (follows the mode ID of enabled outputs)
+            if (rotationRx.indexIn(line) != -1)
+                info.rotation = rotationRx.cap(1);
+
+            // Get physical size
+            if (physicalRx.indexIn(line) != -1)
+            {
+                info.physicalSize = QSize(physicalRx.cap(1).toInt(),
+                                          physicalRx.cap(2).toInt());
+            }
+
+            inventory.outputs.append(info);
+        }
+
+        // Lines below belong to an output
+        else if (inventory.outputs.isEmpty())
+            continue;
+
+        // Output property, check if the EDID begins
+        else if (line.startsWith('\t'))
+        {
+            const QString property = line.trimmed();
+            if (property.startsWith("EDID:"))
+            {
+                readingEdid = true;
+                edidHex.clear();
+            }
+
+            // Transform matrix (one row per line)
+            else if (property.startsWith("Transform:") && i + 2 < lines.count())
+            {
+                const QString matrix = QString("%1 %2 %3")
+                                           .arg(property.mid(10))
+                                           .arg(lines.at(i + 1))
+                                           .arg(lines.at(i + 2));
+                const QStringList values = matrix.split(' ', Qt::SkipEmptyParts);
+                for (int j = 0; j < values.count() && j < 9; ++j)
+                    inventory.outputs.last().transform.append(values.at(j).toDouble());
+
+                i += 2;
+            }
+
+            // Panning area
+            else if (property.startsWith("Panning:")
+                     && geometryRx.indexIn(property) != -1)
+            {
+                inventory.outputs.last().panning
+                    = QRect(geometryRx.cap(3).toInt(), geometryRx.cap(4).toInt(),
+                            geometryRx.cap(1).toInt(), geometryRx.cap(2).toInt());
+            }
+
+            // CRTCs that can drive the output
+            else if (property.startsWith("CRTCs:"))
+            {
+                const QStringList crtcs = property.mid(6).split(' ', Qt::SkipEmptyParts);
+                for (int j = 0; j < crtcs.count(); ++j)
+                    inventory.outputs.last().crtcs.append(crtcs.at(j).toInt());
+            }
+        }
+
+        // Mode information
+        else if (modeRx.indexIn(line) != -1)
+        {
+            ModeInfo mode;
+            mode.name = modeRx.cap(1);
+            mode.id = modeRx.cap(2);
+            mode.pixelClock = modeRx.cap(3).toDouble();
+            mode.current = modeRx.cap(4).contains("*current");
+            mode.preferred = modeRx.cap(4).contains("+preferred");
+            if (sizeRx.indexIn(mode.name) != -1)
+                mode.size = QSize(sizeRx.cap(1).toInt(), sizeRx.cap(2).toInt());
+
+            inventory.outputs.last().modes.append(mode);
+        }
+
+        // Vertical timings of the last mode
+        else if (refreshRx.indexIn(line) != -1)
+        {
+            if (!inventory.outputs.last().modes.isEmpty())
+                inventory.outputs.last().modes.last().refresh
+                    = refreshRx.cap(1).toDouble();
+        }
+    }
+
+    // Register EDID if the output ended while reading it
+    if (readingEdid && !inventory.outputs.isEmpty())
+        inventory.outputs.last().edid = QByteArray::fromHex(edidHex);
+
+    // Use the EDID physical size if xrandr did not report it
+    for (int i = 0; i < inventory.outputs.count(); ++i)
+    {
+        OutputInfo &info = inventory.outputs[i];
+        if (info.physicalSize.isEmpty())
+            info.physicalSize = EdidGetPhysicalSize(info.edid);
+    }
+
+    return inventory;
+}
+
+/**
+ * Returns the outputs of the @a inventory that have a display connected
+ */
+QList<OutputInfo> InventoryConnectedOutputs(const ScreenInventory &inventory)
+{
+    QList<OutputInfo> outputs;
+    for (int i = 0; i < inventory.outputs.count(); ++i)
+    {
+        if (inventory.outputs.at(i).connected && !inventory.outputs.at(i).modes.isEmpty())
+            outputs.append(inventory.outputs.at(i));
+    }
+
+    return outputs;
+}
+
+/**
+ * Returns the preferred mode of the @a output, or its current mode if no
+ * mode is marked as preferred
+ */
+ModeInfo InventoryPreferredMode(const OutputInfo &output)
+{
+    for (int i = 0; i < output.modes.count(); ++i)
+    {
+        if (output.modes.at(i).preferred)
+            return output.modes.at(i);
+    }
+
+    for (int i = 0; i < output.modes.count(); ++i)
+    {
+        if (output.modes.at(i).current)
+            return output.modes.at(i);
+    }
+
+    if (!output.modes.isEmpty())
+        return output.modes.first();
+
+    return ModeInfo();
+}
+
+/**
+ * Returns the resolutions (<width>x<height>) supported by the @a output,
+ * skipping duplicates and resolutions smaller than 640x480
+ */
+QStringList InventoryResolutions(const OutputInfo &output)
+{
+    QStringList resolutions;
+    for (int i = 0; i < output.modes.count(); ++i)
+    {
+        const QSize size = output.modes.at(i).size;
+        if (size.width() < 640 || size.height() < 480)
+            continue;
+
+        const QString resolution = QString("%1x%2").arg(size.width()).arg(size.height());
+        if (!resolutions.contains(resolution))
+            resolutions.append(resolution);
+    }
+
+    return resolutions;
+}
+
+/**
+ * Serializes the given @a inventory to a JSON object
+ */
+QJsonObject InventoryToJson(const ScreenInventory &inventory)
+{
+    QJsonArray outputs;
+    for (int i = 0; i < inventory.outputs.count(); ++i)
+    {
+        const OutputInfo &info = inventory.outputs.at(i);
+
+        QJsonArray modes;
+        for (int j = 0; j < info.modes.count(); ++j)
+        {
+            const ModeInfo &mode = info.modes.at(j);
+
+            QJsonObject modeJson;
+            modeJson.insert("name", mode.name);
+            modeJson.insert("id", mode.id);
+            modeJson.insert("width", mode.size.width());
+            modeJson.insert("height", mode.size.height());
+            modeJson.insert("refresh", mode.refresh);
+            modeJson.insert("pixelClock", mode.pixelClock);
+            modeJson.insert("current", mode.current);
+            modeJson.insert("preferred", mode.preferred);
+            modes.append(modeJson);
+        }
+
+        QJsonArray crtcs;
+        for (int j = 0; j < info.crtcs.count(); ++j)
+            crtcs.append(info.crtcs.at(j));
+
+        QJsonArray transform;
+        for (int j = 0; j < info.transform.count(); ++j)
+            transform.append(info.transform.at(j));
+
+        QJsonObject outputJson;
+        outputJson.insert("name", info.name);
+        outputJson.insert("connected", info.connected);
+        outputJson.insert("primary", info.primary);
+        outputJson.insert("x", info.geometry.x());
+        outputJson.insert("y", info.geometry.y());
+        outputJson.insert("width", info.geometry.width());
+        outputJson.insert("height", info.geometry.height());
+        outputJson.insert("rotation", info.rotation);
+        outputJson.insert("panning", QString("%1x%2+%3+%4")
+                                         .arg(info.panning.width())
+                                         .arg(info.panning.height())
+                                         .arg(info.panning.x())
+                                         .arg(info.panning.y()));
+        outputJson.insert("transform", transform);
+        outputJson.insert("mmWidth", info.physicalSize.width());
+        outputJson.insert("mmHeight", info.physicalSize.height());
+        outputJson.insert("edid", QString::fromLatin1(info.edid.toHex()));
+        outputJson.insert("crtcs", crtcs);
+        outputJson.insert("modes", modes);
+        outputs.append(outputJson);
+    }
+
+    QJsonObject object;
+    object.insert("minWidth", inventory.minimum.width());
+    object.insert("minHeight", inventory.minimum.height());
+    object.insert("width", inventory.current.width());
+    object.insert("height", inventory.current.height());
+    object.insert("maxWidth", inventory.maximum.width());
+    object.insert("maxHeight", inventory.maximum.height());
+    object.insert("outputs", outputs);
+    return object;
+}
+
+/**
+ * Reads an inventory serialized with InventoryToJson()
+ */
+ScreenInventory InventoryFromJson(const QJsonObject &object)
+{
+    QRegExp geometryRx("([0-9]+)x([0-9]+)\\+([0-9]+)\\+([0-9]+)");
+
+    ScreenInventory inventory;
+    inventory.minimum = QSize(object.value("minWidth").toInt(),
+                              object.value("minHeight").toInt());
+    inventory.current
+        = QSize(object.value("width").toInt(), object.value("height").toInt());
+    inventory.maximum = QSize(object.value("maxWidth").toInt(),
+                              object.value("maxHeight").toInt());
+
+    const QJsonArray outputs = object.value("outputs").toArray();
+    for (int i = 0; i < outputs.count(); ++i)
+    {
+        const QJsonObject outputJson = outputs.at(i).toObject();
+
+        OutputInfo info;
+        info.name = outputJson.value("name").toString();
+        info.connected = outputJson.value("connected").toBool();
+        info.primary = outputJson.value("primary").toBool();
+        info.geometry = QRect(outputJson.value("x").toInt(),
+                              outputJson.value("y").toInt(),
+                              outputJson.value("width").toInt(),
+                              outputJson.value("height").toInt());
+        info.rotation = outputJson.value("rotation").toString();
+        if (geometryRx.indexIn(outputJson.value("panning").toString()) != -1)
+        {
+            info.panning = QRect(geometryRx.cap(3).toInt(), geometryRx.cap(4).toInt(),
+                                 geometryRx.cap(1).toInt(), geometryRx.cap(2).toInt());
+        }
+
+        const QJsonArray transform = outputJson.value("transform").toArray();
+        for (int j = 0; j < transform.count(); ++j)
+            info.transform.append(transform.at(j).toDouble());
+
+        info.physicalSize = QSize(outputJson.value("mmWidth").toInt(),
+                                  outputJson.value("mmHeight").toInt());
+        info.edid = QByteArray::fromHex(outputJson.value("edid").toString().toLatin1());
+
+        const QJsonArray crtcs = outputJson.value("crtcs").toArray();
+        for (int j = 0; j < crtcs.count(); ++j)
+            info.crtcs.append(crtcs.at(j).toInt());
+
+        const QJsonArray modes = outputJson.value("modes").toArray();
+        for (int j = 0; j < modes.count(); ++j)
+        {
+            const QJsonObject modeJson = modes.at(j).toObject();
+
+            ModeInfo mode;
+            mode.name = modeJson.value("name").toString();
+            mode.id = modeJson.value("id").toString();
+            mode.size = QSize(modeJson.value("width").toInt(),
+                              modeJson.value("height").toInt());
+            mode.refresh = modeJson.value("refresh").toDouble();
+            mode.pixelClock = modeJson.value("pixelClock").toDouble();
+            mode.current = modeJson.value("current").toBool();
+            mode.preferred = modeJson.value("preferred").toBool();
+            info.modes.append(mode);
+        }
+
+        inventory.outputs.append(info);
+    }
+
+    return inventory;
+}
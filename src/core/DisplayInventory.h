@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DISPLAY_INVENTORY_H
+#define DISPLAY_INVENTORY_H
+
+#include <QList>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+#include <QJsonObject>
+
+/**
+ * Mode reported by xrandr for an output, the pixel clock is given in MHz
+ */
+struct ModeInfo
+{
+    QString name;
+    QString id;
+    QSize size;
+    qreal refresh = 0;
+    qreal pixelClock = 0;
+    bool current = false;
+    bool preferred = false;
+};
+
+/**
+ * Output (connector) reported by xrandr, the physical size is given in mm and
+ * the CRTCs are the indices of the CRTCs that can drive the output. The
+ * transform is the 3x3 matrix of the CRTC in row-major order (empty if
+ * unknown) and the panning area is empty if panning is disabled.
+ */
+struct OutputInfo
+{
+    QString name;
+    bool connected = false;
+    bool primary = false;
+    QRect geometry;
+    QString rotation;
+    QRect panning;
+    QList<qreal> transform;
+    QSize physicalSize;
+    QByteArray edid;
+    QList<int> crtcs;
+    QList<ModeInfo> modes;
+};
+
+/**
+ * State of an X screen, as captured by xrandr --verbose
+ */
+struct ScreenInventory
+{
+    QSize minimum;
+    QSize current;
+    QSize maximum;
+    QList<OutputInfo> outputs;
+};
+
+extern ScreenInventory InventoryParseXrandrVerbose(const QString &output);
+extern QList<OutputInfo> InventoryConnectedOutputs(const ScreenInventory &inventory);
+extern ModeInfo InventoryPreferredMode(const OutputInfo &output);
+extern QStringList InventoryResolutions(const OutputInfo &output);
+
+extern QJsonObject InventoryToJson(const ScreenInventory &inventory);
+extern ScreenInventory InventoryFromJson(const QJsonObject &object);
+
+#endif
@@ -0,0 +1,558 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+
+#include "Cvt.h"
+#include "DisplayLayout.h"
+
+/**
+ * Returns @c true if the @a display is rotated to the left or right, so that
+ * its mode is transposed in the framebuffer
+ */
+static bool IsTransposed(const DisplayConfig &display)
+{
+    return display.rotation == "left" || display.rotation == "right";
+}
+
+/**
+ * Arranges the displays of the @a layout (with their virtual sizes already
+ * set) so that the combined framebuffer is as small as possible while still
+ * fitting inside @a maxFramebuffer (if valid).
+ *
+ * Displays keep the order given by the user, the engine only decides where
+ * a new row begins, so that the resulting arrangement is predictable.
+ */
+static void ArrangeDisplays(DisplayLayout &layout, const QSize &maxFramebuffer)
+{
+    // Nothing to arrange
+    const int count = layout.displays.count();
+    if (count == 0)
+        return;
+
+    // Each bit of the mask tells if the next display begins a new row
+    const int splits = qMin(count - 1, 15);
+    const quint32 combinations = 1u << splits;
+
+    // Try every row arrangement and keep the best one
+    bool bestFits = false;
+    qint64 bestArea = -1;
+    QList<QPoint> bestPositions;
+    for (quint32 mask = 0; mask < combinations; ++mask)
+    {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int rowHeight = 0;
+        QList<QPoint> positions;
+        for (int i = 0; i < count; ++i)
+        {
+            // Begin a new row below the previous one
+            if (i > 0 && i <= splits && (mask & (1u << (i - 1))))
+            {
+                y += rowHeight;
+                x = 0;
+                rowHeight = 0;
+            }
+
+            // Place display at the end of the current row
+            const QSize size = layout.displays.at(i).virtualSize;
+            positions.append(QPoint(x, y));
+            x += size.width();
+            width = qMax(width, x);
+            rowHeight = qMax(rowHeight, size.height());
+        }
+
+        // Get framebuffer size for this arrangement
+        const QSize framebuffer(width, y + rowHeight);
+        const qint64 area = static_cast<qint64>(width) * framebuffer.height();
+        const bool fits = !maxFramebuffer.isValid()
+            || (framebuffer.width() <= maxFramebuffer.width()
+                && framebuffer.height() <= maxFramebuffer.height());
+
+        // Prefer arrangements that fit the screen, then the smallest one
+        if (bestArea < 0 || (fits && !bestFits) || (fits == bestFits && area < bestArea))
+        {
+            bestFits = fits;
+            bestArea = area;
+            bestPositions = positions;
+            layout.framebuffer = framebuffer;
+        }
+    }
+
+    // Apply obtained positions
+    for (int i = 0; i < count; ++i)
+        layout.displays[i].position = bestPositions.at(i);
+}
+
+/**
+ * Calculates the virtual resolution of each display in @a displays and
+ * arranges them so that the combined framebuffer is as small as possible
+ * while still fitting inside @a maxFramebuffer (if valid).
+ */
+DisplayLayout LayoutCompute(const QList<DisplayConfig> &displays,
+                            const QSize &maxFramebuffer)
+{
+    DisplayLayout layout;
+    layout.displays = displays;
+
+    // GNOME only supports a single integer scaling factor, use the largest one
+    for (int i = 0; i < displays.count(); ++i)
+    {
+        int factor = static_cast<int>(ceil(displays.at(i).scale));
+        layout.factor = qMax(layout.factor, factor);
+    }
+
+    // Calculate the screen multiplying factor and virtual size of each display,
+    // the width of the (unrotated) mode is rounded like the custom modes, so
+    // that displays never overlap or leave gaps between them
+    for (int i = 0; i < layout.displays.count(); ++i)
+    {
+        DisplayConfig &display = layout.displays[i];
+        display.multFactor = floor((layout.factor / display.scale) * 1000) / 1000.0;
+        display.virtualSize.setWidth(CvtRoundWidth(
+            static_cast<int>(ceil(display.mode.width() * display.multFactor))));
+        display.virtualSize.setHeight(
+            static_cast<int>(ceil(display.mode.height() * display.multFactor)));
+        if (IsTransposed(display))
+            display.virtualSize.transpose();
+    }
+
+    ArrangeDisplays(layout, maxFramebuffer);
+    return layout;
+}
+
+/**
+ * Returns the shell commands that undo the text DPI method: the font DPI and
+ * cursor size X resources are removed (the X server defaults apply again)
+ * and the GNOME text scaling factor and cursor size are reset.
+ */
+QString LayoutGetTextDpiReset()
+{
+    return "xrdb -query | grep -v -e '^Xft\\.dpi:' -e '^Xcursor\\.size:' "
+           "| xrdb -nocpp -load\n"
+           "gsettings reset org.gnome.desktop.interface text-scaling-factor\n"
+           "gsettings reset org.gnome.desktop.interface cursor-size\n";
+}
+
+/**
+ * Generates a script that configures every display of the @a layout with a
+ * single xrandr call, either by using xrandr --scale or by registering a new
+ * resolution for each display.
+ *
+ * If @a preDesktop is set, the script is meant to run from the X session
+ * startup hook, so it does not wait for the desktop to load.
+ */
+QString LayoutGenerateScript(const DisplayLayout &layout, const bool xrandrScale,
+                             const bool preDesktop)
+{
+    // Scale factor is 1...we don't need a script!
+    if (layout.factor == 1 || layout.displays.isEmpty())
+        return "";
+
+    // Create script string with sh-bang
+    QString script;
+    script.append("#!/bin/bash\n\n");
+
+    // Construct combined xrandr command, each output in its own line
+    QString xrandrCmd = "xrandr";
+    const QStringList arguments = LayoutGetXrandrArguments(layout, xrandrScale);
+    for (int i = 0; i < arguments.count(); ++i)
+    {
+        if (arguments.at(i) == "--output")
+            xrandrCmd.append(" \\\n    ");
+        else
+            xrandrCmd.append(" ");
+
+        xrandrCmd.append(arguments.at(i));
+    }
+
+    // Use xrandr --scale option
+    if (xrandrScale)
+    {
+        // Wait time(to apply changes after GNOME loads up)
+        if (!preDesktop)
+        {
+            script.append("# Wait one second before applying changes\n");
+            script.append("sleep 1\n\n");
+        }
+
+        // Enable rotation lock(to avoid ugly shit when rotating the screen)
+        script.append("# Enable rotation lock  to avoid issues with xrandr.\n");
+        script.append("gsettings set "
+                      "org.gnome.settings-daemon.peripherals.touchscreen "
+                      "orientation-lock true\n\n");
+
+        // Append xrandr --scale command
+        script.append("# Xrandr scaling hack, --panning is used in order to let\n"
+                      "# the mouse navigate in all of the 'generated'\n"
+                      "# screen space.\n");
+        script.append(xrandrCmd);
+        script.append("\n\n");
+    }
+
+    // Create custom resolutions
+    else
+    {
+        for (int i = 0; i < layout.displays.count(); ++i)
+        {
+            // Get modeline and resolution name
+            const DisplayConfig &display = layout.displays.at(i);
+            const QString modeline = LayoutGetModeline(display);
+            const QString resName = CvtGetResolutionName(modeline);
+
+            // Create new resolution
+            script.append(QString("# Create new resolution for %1\n").arg(display.name));
+            script.append(QString("xrandr --newmode %1\n\n").arg(modeline));
+
+            // Register resolution with display
+            script.append(QString("# Register resolution with %1\n").arg(display.name));
+            script.append(
+                QString("xrandr --addmode %1 %2\n\n").arg(display.name).arg(resName));
+        }
+
+        // Change resolution and position of all displays at once
+        script.append("# Apply the combined display layout\n");
+        script.append(xrandrCmd);
+        script.append("\n\n");
+    }
+
+    // Undo the changes of the text DPI method
+    script.append("# Reset font DPI, text scaling factor and cursor size\n");
+    script.append(LayoutGetTextDpiReset());
+    script.append("\n");
+
+    // Set scaling factor (GNOME)
+    script.append("# Change scaling factor (GNOME)\n");
+    script.append(
+        QString("gsettings set org.gnome.desktop.interface scaling-factor %1\n\n")
+            .arg(layout.factor));
+
+    // Echo code
+    script.append("# Confirm script execution\n");
+    script.append("echo \"Script finished execution\"\n");
+
+    // Return generated script
+    return script;
+}
+
+/**
+ * Generates a script that keeps the native resolution of every display of the
+ * @a layout and reaches the largest scale of the layout by increasing the
+ * font DPI (Xft.dpi), the GNOME text scaling factor (exported to the apps
+ * through XSETTINGS) and the cursor size.
+ *
+ * This avoids rendering into an oversized framebuffer, at the cost of only
+ * scaling text and cursors in fractional steps (GNOME still uses its integer
+ * scaling factor for the rest of the UI).
+ */
+QString LayoutGenerateTextDpiScript(const DisplayLayout &layout, const bool preDesktop)
+{
+    // Get the scale of the layout
+    qreal scale = 1;
+    for (int i = 0; i < layout.displays.count(); ++i)
+        scale = qMax(scale, layout.displays.at(i).scale);
+
+    // Scale factor is 1...we don't need a script!
+    if (scale <= 1 || layout.displays.isEmpty())
+        return "";
+
+    // Split the scale into an integer factor and a text scaling factor
+    const int factor = static_cast<int>(floor(scale));
+    const qreal textFactor = floor((scale / factor) * 1000) / 1000.0;
+    const int dpi = qRound(96 * scale);
+    const int cursorSize = qRound(24 * scale);
+
+    // Create script string with sh-bang
+    QString script;
+    script.append("#!/bin/bash\n\n");
+
+    // Wait time (to apply changes after GNOME loads up)
+    if (!preDesktop)
+    {
+        script.append("# Wait one second before applying changes\n");
+        script.append("sleep 1\n\n");
+    }
+
+    // Restore native modes (undoes the changes of the other methods)
+    script.append("# Use the native resolution of each display\n");
+    script.append("xrandr");
+    const QStringList arguments = LayoutGetXrandrArguments(LayoutNative(layout), true);
+    for (int i = 0; i < arguments.count(); ++i)
+    {
+        if (arguments.at(i) == "--output")
+            script.append(" \\\n    ");
+        else
+            script.append(" ");
+
+        script.append(arguments.at(i));
+    }
+    script.append("\n\n");
+
+    // Undo the rotation lock enabled by the xrandr --scale method
+    script.append("# Reset rotation lock (enabled by xrandr --scale scripts)\n");
+    script.append("gsettings reset "
+                  "org.gnome.settings-daemon.peripherals.touchscreen "
+                  "orientation-lock\n\n");
+
+    // Set font DPI and cursor size of X11 applications
+    script.append("# Change font DPI and cursor size (X resources)\n");
+    script.append("xrdb -merge <<EOF\n");
+    script.append(QString("Xft.dpi: %1\n").arg(dpi));
+    script.append(QString("Xcursor.size: %1\n").arg(cursorSize));
+    script.append("EOF\n\n");
+
+    // Set scaling factors (GNOME exports them through XSETTINGS)
+    script.append("# Change scaling factors and cursor size (GNOME/XSETTINGS)\n");
+    script.append(
+        QString("gsettings set org.gnome.desktop.interface scaling-factor %1\n")
+            .arg(factor));
+    script.append(
+        QString("gsettings set org.gnome.desktop.interface text-scaling-factor %1\n")
+            .arg(textFactor));
+    script.append(QString("gsettings set org.gnome.desktop.interface cursor-size %1\n\n")
+                      .arg(cursorSize));
+
+    // Echo code
+    script.append("# Confirm script execution\n");
+    script.append("echo \"Script finished execution\"\n");
+
+    // Return generated script
+    return script;
+}
+
+/**
+ * Returns the environment variables that make Qt and GTK apps render at the
+ * density of each display of the @a layout, without scaling twice.
+ *
+ * With the xrandr methods every display is drawn at the GNOME integer factor
+ * and then resampled, so that is the factor of every screen. With the text
+ * DPI method the displays keep their native modes, so each screen uses its
+ * own (fractional) scale. In both cases Xft.dpi already includes the scale,
+ * so the font DPI of the toolkits is reset to avoid enlarging text twice.
+ *
+ * Qt ignores QT_SCREEN_SCALE_FACTORS unless it lists every screen, so the
+ * connected @a outputs that are not part of the layout are listed too (at
+ * the GNOME factor, or unscaled with the text DPI method).
+ */
+QStringList LayoutGetToolkitEnvironment(const DisplayLayout &layout,
+                                        const QStringList &outputs, const bool textDpi)
+{
+    // Get the scale of the layout
+    qreal scale = 1;
+    for (int i = 0; i < layout.displays.count(); ++i)
+        scale = qMax(scale, layout.displays.at(i).scale);
+
+    // Nothing is scaled, use the toolkit defaults
+    if (scale <= 1 || layout.displays.isEmpty())
+        return QStringList();
+
+    // Get the integer factor used by GNOME/XSETTINGS
+    int factor = layout.factor;
+    if (textDpi)
+        factor = static_cast<int>(floor(scale));
+
+    // Get the factor of each Qt screen (named after its output)
+    QStringList names;
+    QStringList screens;
+    for (int i = 0; i < layout.displays.count(); ++i)
+    {
+        const DisplayConfig &display = layout.displays.at(i);
+        const qreal screenFactor = textDpi ? display.scale : factor;
+        names.append(display.name);
+        screens.append(QString("%1=%2").arg(display.name).arg(screenFactor));
+    }
+
+    // Add the screens that keep their current configuration
+    for (int i = 0; i < outputs.count(); ++i)
+    {
+        if (!names.contains(outputs.at(i)))
+            screens.append(QString("%1=%2").arg(outputs.at(i)).arg(textDpi ? 1 : factor));
+    }
+
+    // GTK only supports an integer factor, text is corrected through its DPI
+    QStringList exports;
+    exports.append("export QT_AUTO_SCREEN_SCALE_FACTOR=0");
+    exports.append(
+        QString("export QT_SCREEN_SCALE_FACTORS=\"%1\"").arg(screens.join(';')));
+    exports.append("export QT_FONT_DPI=96");
+    exports.append(QString("export GDK_SCALE=%1").arg(factor));
+    exports.append(QString("export GDK_DPI_SCALE=%1").arg(1.0 / factor, 0, 'g', 4));
+    return exports;
+}
+
+/**
+ * Returns a copy of the @a layout in which every display uses its native
+ * mode without any scaling
+ */
+DisplayLayout LayoutNative(const DisplayLayout &layout)
+{
+    DisplayLayout native;
+    native.complete = layout.complete;
+    native.displays = layout.displays;
+    for (int i = 0; i < native.displays.count(); ++i)
+    {
+        DisplayConfig &display = native.displays[i];
+        display.scale = 1;
+        display.multFactor = 1;
+        display.virtualSize = display.mode;
+        if (IsTransposed(display))
+            display.virtualSize.transpose();
+    }
+
+    ArrangeDisplays(native, QSize());
+    return native;
+}
+
+/**
+ * Estimates the framebuffer memory and the pixels drawn per frame when the
+ * @a layout is applied with the given method. With xrandr --scale, the
+ * scaled framebuffer is sampled once more to produce each native mode.
+ */
+LayoutCost LayoutEstimateCost(const DisplayLayout &layout, const bool xrandrScale)
+{
+    LayoutCost cost;
+    const QSize fb = layout.framebuffer;
+    cost.framebufferBytes = static_cast<qint64>(fb.width()) * fb.height() * 4;
+
+    for (int i = 0; i < layout.displays.count(); ++i)
+    {
+        const QSize mode = layout.displays.at(i).mode;
+        const QSize virtualSize = layout.displays.at(i).virtualSize;
+        cost.framePixels
+            += static_cast<qint64>(virtualSize.width()) * virtualSize.height();
+        if (xrandrScale)
+            cost.framePixels += static_cast<qint64>(mode.width()) * mode.height();
+    }
+
+    return cost;
+}
+
+/**
+ * Returns the virtual size of the @a display in the orientation of its mode
+ * (swapped back for the left and right rotations), which is the size of the
+ * custom mode and the xrandr --scale-from area
+ */
+QSize LayoutGetScaleFrom(const DisplayConfig &display)
+{
+    if (IsTransposed(display))
+        return display.virtualSize.transposed();
+
+    return display.virtualSize;
+}
+
+/**
+ * Returns the CVT modeline used to create the virtual resolution of the
+ * given @a display
+ */
+QString LayoutGetModeline(const DisplayConfig &display)
+{
+    const QSize size = LayoutGetScaleFrom(display);
+    return CvtGetModeline(size.width(), size.height(), display.refresh);
+}
+
+/**
+ * Returns the name (without quotes) of the mode created for the virtual
+ * resolution of the given @a display
+ */
+QString LayoutGetModeName(const DisplayConfig &display)
+{
+    return CvtGetResolutionName(LayoutGetModeline(display)).remove('"');
+}
+
+/**
+ * Returns the arguments of the single xrandr call that applies the
+ * @a layout, shared by the generated scripts and the display backends.
+ *
+ * The framebuffer size and the display positions are only set if the layout
+ * is complete, otherwise xrandr keeps the position of each display and grows
+ * the framebuffer as needed, without moving the other displays.
+ */
+QStringList LayoutGetXrandrArguments(const DisplayLayout &layout, const bool xrandrScale)
+{
+    // Begin with the size of the framebuffer
+    QStringList arguments;
+    if (layout.complete)
+        arguments << "--fb"
+                  << QString("%1x%2")
+                         .arg(layout.framebuffer.width())
+                         .arg(layout.framebuffer.height());
+
+    // Add each display
+    for (int i = 0; i < layout.displays.count(); ++i)
+    {
+        const DisplayConfig &display = layout.displays.at(i);
+
+        // Use xrandr --scale-from (so that the mode fills exactly the virtual
+        // size), --panning is used to let the mouse navigate in all of the
+        // 'generated' screen space
+        if (xrandrScale)
+        {
+            const QSize scaleFrom = LayoutGetScaleFrom(display);
+            QString panning = QString("%1x%2")
+                                  .arg(display.virtualSize.width())
+                                  .arg(display.virtualSize.height());
+            if (layout.complete)
+                panning.append(QString("+%1+%2")
+                                   .arg(display.position.x())
+                                   .arg(display.position.y()));
+
+            arguments << "--output" << display.name << "--mode"
+                      << QString("%1x%2")
+                             .arg(display.mode.width())
+                             .arg(display.mode.height())
+                      << "--scale-from"
+                      << QString("%1x%2")
+                             .arg(scaleFrom.width())
+                             .arg(scaleFrom.height())
+                      << "--panning" << panning;
+
+            // Use a specific refresh rate
+            if (display.refresh > 0)
+                arguments << "--rate" << QString::number(display.refresh);
+        }
+
+        // Use the custom resolution, without the scaling and panning left
+        // by the --scale method (or by the native layout of the text DPI one)
+        else
+        {
+            arguments << "--output" << display.name << "--mode"
+                      << LayoutGetModeName(display) << "--scale"
+                      << "1x1"
+                      << "--panning"
+                      << "0x0";
+        }
+
+        // Keep the rotation of the display
+        if (!display.rotation.isEmpty())
+            arguments << "--rotate" << display.rotation;
+
+        // Set position of the display
+        if (layout.complete)
+            arguments << "--pos"
+                      << QString("%1x%2")
+                             .arg(display.position.x())
+                             .arg(display.position.y());
+    }
+
+    return arguments;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DISPLAY_LAYOUT_H
+#define DISPLAY_LAYOUT_H
+
+#include <QList>
+#include <QSize>
+#include <QPoint>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Holds the user-selected mode, scale and refresh rate (0 for the default
+ * rate) of a single output and its current xrandr rotation (empty for
+ * "normal"), the remaining fields are filled by the layout engine.
+ */
+struct DisplayConfig
+{
+    QString name;
+    QSize mode;
+    qreal scale = 1;
+    qreal refresh = 0;
+    QString rotation;
+
+    qreal multFactor = 1;
+    QSize virtualSize;
+    QPoint position;
+};
+
+/**
+ * Combined configuration for the outputs that share the X screen. If the
+ * layout is not @c complete (it does not cover every connected output), the
+ * framebuffer and positions are not applied, the other outputs keep their
+ * current configuration.
+ */
+struct DisplayLayout
+{
+    int factor = 1;
+    bool complete = true;
+    QSize framebuffer;
+    QList<DisplayConfig> displays;
+};
+
+/**
+ * Estimated memory and rendering cost of a layout: bytes of the framebuffer
+ * (32 bpp) and pixels drawn each frame to refresh every display
+ */
+struct LayoutCost
+{
+    qint64 framebufferBytes = 0;
+    qint64 framePixels = 0;
+};
+
+extern DisplayLayout LayoutCompute(const QList<DisplayConfig> &displays,
+                                   const QSize &maxFramebuffer);
+extern QString LayoutGenerateScript(const DisplayLayout &layout, const bool xrandrScale,
+                                    const bool preDesktop);
+extern QString LayoutGenerateTextDpiScript(const DisplayLayout &layout,
+                                           const bool preDesktop);
+extern QString LayoutGetTextDpiReset();
+extern QStringList LayoutGetToolkitEnvironment(const DisplayLayout &layout,
+                                               const QStringList &outputs,
+                                               const bool textDpi);
+
+extern DisplayLayout LayoutNative(const DisplayLayout &layout);
+extern LayoutCost LayoutEstimateCost(const DisplayLayout &layout, const bool xrandrScale);
+
+extern QSize LayoutGetScaleFrom(const DisplayConfig &display);
+extern QString LayoutGetModeline(const DisplayConfig &display);
+extern QString LayoutGetModeName(const DisplayConfig &display);
+extern QStringList LayoutGetXrandrArguments(const DisplayLayout &layout,
+                                            const bool xrandrScale);
+
+#endif
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+#include <QProcess>
+
+#include "ScriptFile.h"
+#include "DisplaySnapshot.h"
+
+/**
+ * GNOME settings changed by the generated scripts
+ */
+static const QStringList SETTINGS = {
+    "org.gnome.desktop.interface scaling-factor",
+    "org.gnome.desktop.interface text-scaling-factor",
+    "org.gnome.desktop.interface cursor-size",
+    "org.gnome.settings-daemon.peripherals.touchscreen orientation-lock",
+};
+
+/**
+ * X resources changed by the generated scripts
+ */
+static const QStringList RESOURCES = {
+    "Xcursor.size",
+    "Xft.dpi",
+};
+
+/**
+ * Runs the given @a program and returns its standard output, or an empty
+ * string if the program fails
+ */
+static QString ReadProcessOutput(const QString &program, const QStringList &arguments)
+{
+    QProcess process;
+    process.start(program, arguments);
+    if (!process.waitForFinished() || process.exitStatus() != QProcess::NormalExit
+        || process.exitCode() != 0)
+        return QString();
+
+    return QString::fromUtf8(process.readAllStandardOutput()).trimmed();
+}
+
+/**
+ * Returns @c true if the given @a transform is the identity matrix (or is
+ * unknown)
+ */
+static bool IsIdentity(const QList<qreal> &transform)
+{
+    if (transform.count() != 9)
+        return true;
+
+    for (int i = 0; i < 9; ++i)
+    {
+        const qreal expected = (i % 4 == 0) ? 1 : 0;
+        if (qAbs(transform.at(i) - expected) > 0.00001)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Reads the current outputs, modes, positions, transforms and panning areas
+ * through the @a backend, together with the desktop settings and X resources
+ * that HiDPI Fixer may change, and stores them in @a snapshot.
+ */
+bool SnapshotCapture(DisplayBackend *backend, DisplaySnapshot &snapshot)
+{
+    snapshot = DisplaySnapshot();
+    snapshot.time = QDateTime::currentDateTime();
+
+    // Get display state
+    if (!backend || !backend->inventory(snapshot.screen))
+        return false;
+
+    // Get desktop settings (skipped if the schema is not installed)
+    for (int i = 0; i < SETTINGS.count(); ++i)
+    {
+        const QStringList arguments = QStringList("get") + SETTINGS.at(i).split(' ');
+        const QString value = ReadProcessOutput("gsettings", arguments);
+        if (!value.isEmpty())
+            snapshot.settings.insert(SETTINGS.at(i), value);
+    }
+
+    // Get X resources (empty values mean that they are not set)
+    const QStringList lines = ReadProcessOutput("xrdb", { "-query" }).split('\n');
+    for (int i = 0; i < RESOURCES.count(); ++i)
+    {
+        const QString name = RESOURCES.at(i);
+        snapshot.resources.insert(name, QString());
+        for (int j = 0; j < lines.count(); ++j)
+        {
+            if (lines.at(j).startsWith(name + ":"))
+            {
+                const QString value = lines.at(j).mid(name.length() + 1).trimmed();
+                snapshot.resources.insert(name, value);
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Returns the arguments of the single xrandr call that restores the screen
+ * size and the mode, position, rotation, transform and panning area of every
+ * connected output of the @a snapshot
+ */
+QStringList SnapshotGetXrandrArguments(const DisplaySnapshot &snapshot)
+{
+    // Begin with the size of the framebuffer
+    QStringList arguments;
+    if (snapshot.screen.current.isValid())
+    {
+        arguments << "--fb"
+                  << QString("%1x%2")
+                         .arg(snapshot.screen.current.width())
+                         .arg(snapshot.screen.current.height());
+    }
+
+    // Add each connected output
+    for (int i = 0; i < snapshot.screen.outputs.count(); ++i)
+    {
+        const OutputInfo &output = snapshot.screen.outputs.at(i);
+        if (!output.connected)
+            continue;
+
+        // Get current mode (the output is disabled if there is none)
+        ModeInfo mode;
+        for (int j = 0; j < output.modes.count(); ++j)
+        {
+            if (output.modes.at(j).current)
+                mode = output.modes.at(j);
+        }
+
+        arguments << "--output" << output.name;
+        if (mode.id.isEmpty() || output.geometry.isEmpty())
+        {
+            arguments << "--off";
+            continue;
+        }
+
+        // Use the mode ID, names are not unique
+        arguments << "--mode" << mode.id << "--pos"
+                  << QString("%1x%2").arg(output.geometry.x()).arg(output.geometry.y());
+
+        // Restore rotation
+        if (!output.rotation.isEmpty())
+            arguments << "--rotate" << output.rotation;
+
+        // Restore transform (also resets --scale)
+        if (IsIdentity(output.transform))
+            arguments << "--transform"
+                      << "none";
+        else
+        {
+            QStringList values;
+            for (int j = 0; j < output.transform.count(); ++j)
+                values.append(QString::number(output.transform.at(j), 'f', 6));
+
+            arguments << "--transform" << values.join(',');
+        }
+
+        // Restore (or disable) panning
+        if (output.panning.isEmpty())
+            arguments << "--panning"
+                      << "0x0";
+        else
+            arguments << "--panning"
+                      << QString("%1x%2+%3+%4")
+                             .arg(output.panning.width())
+                             .arg(output.panning.height())
+                             .arg(output.panning.x())
+                             .arg(output.panning.y());
+
+        if (output.primary)
+            arguments << "--primary";
+    }
+
+    return arguments;
+}
+
+/**
+ * Generates a script that restores the state saved in the @a snapshot,
+ * the displays are restored with a single xrandr call.
+ */
+QString SnapshotGenerateScript(const DisplaySnapshot &snapshot)
+{
+    // Create script string with sh-bang
+    QString script;
+    script.append("#!/bin/bash\n\n");
+
+    // Restore displays with a single xrandr call
+    script.append(QString("# Restore the display configuration of %1\n")
+                      .arg(snapshot.time.toString(Qt::ISODate)));
+    script.append("xrandr");
+    const QStringList arguments = SnapshotGetXrandrArguments(snapshot);
+    for (int i = 0; i < arguments.count(); ++i)
+    {
+        if (arguments.at(i) == "--output")
+            script.append(" \\\n    ");
+        else
+            script.append(" ");
+
+        script.append(arguments.at(i));
+    }
+    script.append("\n\n");
+
+    // Restore X resources, the ones that were not set are removed again (so
+    // that the X server defaults apply, like LayoutGetTextDpiReset)
+    QStringList set;
+    QStringList unset;
+    const QStringList names = snapshot.resources.keys();
+    for (int i = 0; i < names.count(); ++i)
+    {
+        const QString value = snapshot.resources.value(names.at(i));
+        if (value.isEmpty())
+            unset.append(QString("%1:\n").arg(names.at(i)));
+        else
+            set.append(QString("%1: %2\n").arg(names.at(i)).arg(value));
+    }
+    if (!names.isEmpty())
+        script.append("# Restore font DPI and cursor size (X resources)\n");
+    if (!set.isEmpty())
+        script.append(QString("xrdb -nocpp -merge <<EOF\n%1EOF\n").arg(set.join("")));
+    if (!unset.isEmpty())
+        script.append(QString("xrdb -nocpp -remove <<EOF\n%1EOF\n").arg(unset.join("")));
+    if (!names.isEmpty())
+        script.append("\n");
+
+    // Restore GNOME settings
+    if (!snapshot.settings.isEmpty())
+    {
+        script.append("# Restore scaling factors (GNOME)\n");
+        const QStringList keys = snapshot.settings.keys();
+        for (int i = 0; i < keys.count(); ++i)
+            script.append(QString("gsettings set %1 \"%2\"\n")
+                              .arg(keys.at(i))
+                              .arg(snapshot.settings.value(keys.at(i))));
+        script.append("\n");
+    }
+
+    // Echo code
+    script.append("# Confirm script execution\n");
+    script.append("echo \"Script finished execution\"\n");
+
+    // Return generated script
+    return script;
+}
+
+/**
+ * Saves the script that restores the @a snapshot to the given @a path and
+ * makes it executable, so that it can also be run by hand (e.g. from a
+ * terminal with DISPLAY=:0) if the screen becomes unusable.
+ */
+bool SnapshotSaveRevertScript(const DisplaySnapshot &snapshot, const QString &path)
+{
+    return ScriptSave(path, SnapshotGenerateScript(snapshot));
+}
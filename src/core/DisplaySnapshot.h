@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DISPLAY_SNAPSHOT_H
+#define DISPLAY_SNAPSHOT_H
+
+#include <QMap>
+#include <QString>
+#include <QDateTime>
+#include <QStringList>
+
+#include "DisplayBackend.h"
+#include "DisplayInventory.h"
+
+/**
+ * State of the displays and desktop settings before HiDPI Fixer changes them,
+ * settings are stored as "<schema> <key>" (or X resource names) and values,
+ * X resources that were not set have empty values
+ */
+struct DisplaySnapshot
+{
+    QDateTime time;
+    ScreenInventory screen;
+    QMap<QString, QString> settings;
+    QMap<QString, QString> resources;
+};
+
+extern bool SnapshotCapture(DisplayBackend *backend, DisplaySnapshot &snapshot);
+extern QStringList SnapshotGetXrandrArguments(const DisplaySnapshot &snapshot);
+extern QString SnapshotGenerateScript(const DisplaySnapshot &snapshot);
+extern bool SnapshotSaveRevertScript(const DisplaySnapshot &snapshot,
+                                     const QString &path);
+
+#endif
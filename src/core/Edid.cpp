@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Edid.h"
+
+/**
+ * Returns @c true if @a edid begins with a valid EDID 1.x base block
+ */
+bool EdidIsValid(const QByteArray &edid)
+{
+    // Check size of base block
+    if (edid.size() < 128)
+        return false;
+
+    // Check header (00 ff ff ff ff ff ff 00)
+    static const QByteArray header = QByteArray::fromHex("00ffffffffffff00");
+    if (edid.left(8) != header)
+        return false;
+
+    // Check that the base block checksum is 0
+    quint8 sum = 0;
+    for (int i = 0; i < 128; ++i)
+        sum += static_cast<quint8>(edid.at(i));
+
+    return sum == 0;
+}
+
+/**
+ * Returns the physical size of the display in millimeters, or an invalid size
+ * if the EDID does not report it
+ */
+QSize EdidGetPhysicalSize(const QByteArray &edid)
+{
+    if (!EdidIsValid(edid))
+        return QSize();
+
+    // Use the size of the preferred detailed timing descriptor (mm)
+    const int clock = static_cast<quint8>(edid.at(54))
+        | (static_cast<quint8>(edid.at(55)) << 8);
+    if (clock != 0)
+    {
+        const int w = static_cast<quint8>(edid.at(66))
+            | ((static_cast<quint8>(edid.at(68)) & 0xf0) << 4);
+        const int h = static_cast<quint8>(edid.at(67))
+            | ((static_cast<quint8>(edid.at(68)) & 0x0f) << 8);
+        if (w > 0 && h > 0)
+            return QSize(w, h);
+    }
+
+    // Use the basic display parameters (cm)
+    const int w = static_cast<quint8>(edid.at(21));
+    const int h = static_cast<quint8>(edid.at(22));
+    if (w > 0 && h > 0)
+        return QSize(w * 10, h * 10);
+
+    return QSize();
+}
+
+/**
+ * Returns the monitor name stored in the EDID descriptors, or an empty
+ * string if the EDID does not contain a name
+ */
+QString EdidGetMonitorName(const QByteArray &edid)
+{
+    if (!EdidIsValid(edid))
+        return QString();
+
+    // Look for the display product name descriptor (tag 0xfc)
+    for (int offset = 54; offset <= 108; offset += 18)
+    {
+        if (edid.at(offset) != 0 || edid.at(offset + 1) != 0
+            || static_cast<quint8>(edid.at(offset + 3)) != 0xfc)
+            continue;
+
+        // Name is terminated with a linefeed
+        QByteArray name = edid.mid(offset + 5, 13);
+        int end = name.indexOf('\n');
+        if (end >= 0)
+            name = name.left(end);
+
+        return QString::fromLatin1(name).trimmed();
+    }
+
+    return QString();
+}
+
+/**
+ * Returns the vertical/horizontal rates and maximum pixel clock supported by
+ * the display, the limits are invalid if the EDID does not report them
+ */
+EdidRangeLimits EdidGetRangeLimits(const QByteArray &edid)
+{
+    EdidRangeLimits limits;
+    if (!EdidIsValid(edid))
+        return limits;
+
+    // Look for the display range limits descriptor (tag 0xfd)
+    for (int offset = 54; offset <= 108; offset += 18)
+    {
+        if (edid.at(offset) != 0 || edid.at(offset + 1) != 0
+            || static_cast<quint8>(edid.at(offset + 3)) != 0xfd)
+            continue;
+
+        // EDID 1.4 adds 255 to the rates if the offset flags are set
+        const int flags = static_cast<quint8>(edid.at(offset + 4));
+        limits.minVRate = static_cast<quint8>(edid.at(offset + 5))
+            + ((flags & 0x03) == 0x03 ? 255 : 0);
+        limits.maxVRate
+            = static_cast<quint8>(edid.at(offset + 6)) + (flags & 0x02 ? 255 : 0);
+        limits.minHRate = static_cast<quint8>(edid.at(offset + 7))
+            + ((flags & 0x0c) == 0x0c ? 255 : 0);
+        limits.maxHRate
+            = static_cast<quint8>(edid.at(offset + 8)) + (flags & 0x08 ? 255 : 0);
+
+        // Maximum pixel clock is given in steps of 10 MHz
+        limits.maxPixelClock = static_cast<quint8>(edid.at(offset + 9)) * 10;
+        limits.valid = limits.maxVRate > 0 && limits.maxHRate > 0;
+        return limits;
+    }
+
+    return limits;
+}
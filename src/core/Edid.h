@@ -20,28 +20,29 @@
  * THE SOFTWARE.
  */
 
-#ifndef GLOBAL_H
-#define GLOBAL_H
+#ifndef EDID_H
+#define EDID_H
 
-#include <QDir>
+#include <QSize>
 #include <QString>
+#include <QByteArray>
 
 /**
- * Define application information
+ * Display range limits descriptor of the EDID (rates in Hz/kHz, clock in MHz)
  */
-static const QString APP_VERSION = "1.4";
-static const QString APP_NAME = "HiDPI Fixer";
+struct EdidRangeLimits
+{
+    bool valid = false;
+    int minVRate = 0;
+    int maxVRate = 0;
+    int minHRate = 0;
+    int maxHRate = 0;
+    int maxPixelClock = 0;
+};
 
-/**
- * Defines the folder in which the HiDPI-Fixer scripts are stored
- */
-static const QString SCRIPTS_HOME = QString("%1/.hidpi-fixer").arg(QDir::homePath());
-
-/**
- * Defines the file location and name pattern for startup scripts
- */
-static const QString AUTOSTART_PATTERN = "HiDPI-Fixer_";
-static const QString AUTOSTART_LOCATION
-    = QString("%1/.config/autostart").arg(QDir::homePath());
+extern bool EdidIsValid(const QByteArray &edid);
+extern QSize EdidGetPhysicalSize(const QByteArray &edid);
+extern QString EdidGetMonitorName(const QByteArray &edid);
+extern EdidRangeLimits EdidGetRangeLimits(const QByteArray &edid);
 
 #endif
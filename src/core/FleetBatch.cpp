@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QSet>
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <QRegExp>
+#include <QVector>
+#include <QRunnable>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QThreadPool>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+
+#include <cmath>
+
+#include "Edid.h"
+#include "Preflight.h"
+#include "FleetBatch.h"
+#include "ScriptFile.h"
+#include "DisplayLayout.h"
+
+/**
+ * Captured inventory of a single machine
+ */
+struct BatchJob
+{
+    QString machine;
+    QString fileName;
+    QString xrandrFile;
+    QString edidDir;
+};
+
+/**
+ * Profile generated (or error found) for a single machine
+ */
+struct BatchResult
+{
+    QString machine;
+    QString status;
+    QString error;
+    QString profile;
+    DisplayLayout layout;
+    QStringList monitors;
+};
+
+/**
+ * Generates the profile of a single machine, each task writes to its own
+ * result and profile file, so tasks can run in parallel without locking.
+ */
+class BatchTask : public QRunnable
+{
+public:
+    BatchTask(const BatchJob &job, const BatchPolicy &policy, const QString &outputDir,
+              BatchResult *result)
+        : m_job(job)
+        , m_policy(policy)
+        , m_outputDir(outputDir)
+        , m_result(result)
+    {
+    }
+
+    void run() override
+    {
+        m_result->machine = m_job.machine;
+
+        // Read captured xrandr --verbose output
+        QFile file(m_job.xrandrFile);
+        if (!file.open(QFile::ReadOnly))
+        {
+            fail(QString("Cannot open %1 for reading").arg(m_job.xrandrFile));
+            return;
+        }
+        ScreenInventory inventory
+            = InventoryParseXrandrVerbose(QString::fromUtf8(file.readAll()));
+        file.close();
+
+        // Use captured EDID files (<output>.edid) if available
+        if (!m_job.edidDir.isEmpty())
+        {
+            for (int i = 0; i < inventory.outputs.count(); ++i)
+            {
+                OutputInfo &output = inventory.outputs[i];
+                QFile edid(QString("%1/%2.edid").arg(m_job.edidDir).arg(output.name));
+                if (edid.open(QFile::ReadOnly))
+                {
+                    output.edid = edid.readAll();
+                    if (output.physicalSize.isEmpty())
+                        output.physicalSize = EdidGetPhysicalSize(output.edid);
+                }
+            }
+        }
+
+        // Get connected displays
+        QList<OutputInfo> outputs = InventoryConnectedOutputs(inventory);
+        if (outputs.isEmpty())
+        {
+            fail("No connected displays found");
+            return;
+        }
+
+        // Get monitor names
+        for (int i = 0; i < outputs.count(); ++i)
+            m_result->monitors.append(EdidGetMonitorName(outputs.at(i).edid));
+
+        // Arrange displays and validate the layout against the machine limits
+        m_result->layout = BatchComputeLayout(inventory, m_policy);
+        const QStringList errors
+            = m_policy.textDpi
+            ? PreflightValidate(LayoutNative(m_result->layout), inventory, true)
+            : PreflightValidate(m_result->layout, inventory, m_policy.xrandrScale);
+        if (!errors.isEmpty())
+        {
+            fail(errors.join("; "));
+            return;
+        }
+
+        // Generate script
+        QString script
+            = m_policy.textDpi
+            ? LayoutGenerateTextDpiScript(m_result->layout, m_policy.preDesktop)
+            : LayoutGenerateScript(m_result->layout, m_policy.xrandrScale,
+                                   m_policy.preDesktop);
+        if (script.isEmpty())
+        {
+            m_result->status = "skipped";
+            return;
+        }
+
+        // Save script
+        m_result->profile = QString("%1/%2.sh").arg(m_outputDir).arg(m_job.fileName);
+        if (!ScriptSave(m_result->profile, script))
+        {
+            fail(QString("Cannot write %1").arg(m_result->profile));
+            return;
+        }
+
+        m_result->status = "ok";
+    }
+
+private:
+    void fail(const QString &error)
+    {
+        m_result->status = "error";
+        m_result->error = error;
+    }
+
+private:
+    BatchJob m_job;
+    BatchPolicy m_policy;
+    QString m_outputDir;
+    BatchResult *m_result;
+};
+
+/**
+ * Returns the scale factor that brings the given @a mode of the @a output
+ * close to 96 DPI, rounded to steps of 0.25
+ */
+qreal BatchAutomaticScale(const OutputInfo &output, const ModeInfo &mode)
+{
+    // We cannot get the DPI without the physical size of the display
+    if (output.physicalSize.width() <= 0 || mode.size.width() <= 0)
+        return 1;
+
+    // Get DPI and scale factor
+    const qreal dpi = mode.size.width() * 25.4 / output.physicalSize.width();
+    const qreal scale = round((dpi / 96.0) * 4) / 4.0;
+    return qBound(1.0, scale, 3.0);
+}
+
+/**
+ * Configures each connected display of the @a inventory with its preferred
+ * mode and the scale and refresh rate of the @a policy, and arranges them in
+ * the smallest framebuffer allowed by the screen
+ */
+DisplayLayout BatchComputeLayout(const ScreenInventory &inventory,
+                                 const BatchPolicy &policy)
+{
+    QList<DisplayConfig> displays;
+    const QList<OutputInfo> outputs = InventoryConnectedOutputs(inventory);
+    for (int i = 0; i < outputs.count(); ++i)
+    {
+        const OutputInfo &output = outputs.at(i);
+        const ModeInfo mode = InventoryPreferredMode(output);
+
+        DisplayConfig config;
+        config.name = output.name;
+        config.mode = mode.size;
+        config.rotation = output.rotation;
+        config.refresh = policy.refresh;
+        config.scale
+            = policy.scale > 0 ? policy.scale : BatchAutomaticScale(output, mode);
+        displays.append(config);
+    }
+
+    return LayoutCompute(displays, inventory.maximum);
+}
+
+/**
+ * Returns the inventories found in @a inventoryDir, which may contain one
+ * xrandr --verbose file per machine, or one directory per machine with an
+ * xrandr.txt file and optional <output>.edid files.
+ *
+ * Each job gets a unique profile file name, machines whose sanitized names
+ * collide (e.g. "a b" and "a_b", or "m1.txt" and "m1/") get a numeric suffix.
+ */
+static QList<BatchJob> FindInventories(const QString &inventoryDir)
+{
+    QList<BatchJob> jobs;
+    QSet<QString> fileNames;
+    QDir dir(inventoryDir);
+    const QFileInfoList entries = dir.entryInfoList(
+        QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Readable, QDir::Name);
+
+    for (int i = 0; i < entries.count(); ++i)
+    {
+        const QFileInfo &entry = entries.at(i);
+
+        BatchJob job;
+        if (entry.isDir())
+        {
+            job.machine = entry.fileName();
+            job.edidDir = entry.absoluteFilePath();
+            job.xrandrFile = entry.absoluteFilePath() + "/xrandr.txt";
+            if (!QFile::exists(job.xrandrFile))
+                continue;
+        }
+
+        else
+        {
+            job.machine = entry.completeBaseName();
+            job.xrandrFile = entry.absoluteFilePath();
+        }
+
+        // Get a profile file name that is not used by another machine
+        QString name = job.machine;
+        name.replace(QRegExp("[^A-Za-z0-9._-]"), "_");
+        job.fileName = name;
+        for (int suffix = 2; fileNames.contains(job.fileName); ++suffix)
+            job.fileName = QString("%1-%2").arg(name).arg(suffix);
+
+        if (job.fileName != name)
+            qWarning() << Q_FUNC_INFO << "Profile of" << entry.fileName()
+                       << "saved as" << job.fileName + ".sh";
+
+        fileNames.insert(job.fileName);
+        jobs.append(job);
+    }
+
+    return jobs;
+}
+
+/**
+ * Returns the framebuffer bytes and pixels per frame needed by each scaling
+ * method for the given @a layout
+ */
+static QJsonObject CostToJson(const DisplayLayout &layout)
+{
+    const LayoutCost costs[] = { LayoutEstimateCost(layout, false),
+                                 LayoutEstimateCost(layout, true),
+                                 LayoutEstimateCost(LayoutNative(layout), false) };
+    const char *methods[] = { "mode", "scale", "text" };
+
+    QJsonObject object;
+    for (int i = 0; i < 3; ++i)
+    {
+        QJsonObject cost;
+        cost.insert("framebufferBytes", costs[i].framebufferBytes);
+        cost.insert("framePixels", costs[i].framePixels);
+        object.insert(methods[i], cost);
+    }
+
+    return object;
+}
+
+/**
+ * Converts the given @a result to a JSON object for the batch summary
+ */
+static QJsonObject ResultToJson(const BatchResult &result)
+{
+    QJsonObject object;
+    object.insert("machine", result.machine);
+    object.insert("status", result.status);
+    if (!result.error.isEmpty())
+        object.insert("error", result.error);
+    if (!result.profile.isEmpty())
+        object.insert("profile", result.profile);
+
+    // Only report the layout if it was computed
+    if (result.layout.displays.isEmpty())
+        return object;
+
+    object.insert("factor", result.layout.factor);
+    object.insert("framebuffer", QString("%1x%2")
+                                     .arg(result.layout.framebuffer.width())
+                                     .arg(result.layout.framebuffer.height()));
+
+    QJsonArray displays;
+    for (int i = 0; i < result.layout.displays.count(); ++i)
+    {
+        const DisplayConfig &config = result.layout.displays.at(i);
+
+        QJsonObject display;
+        display.insert("output", config.name);
+        display.insert("monitor", result.monitors.value(i));
+        display.insert("mode", QString("%1x%2")
+                                   .arg(config.mode.width())
+                                   .arg(config.mode.height()));
+        display.insert("scale", config.scale);
+        display.insert("virtual", QString("%1x%2")
+                                      .arg(config.virtualSize.width())
+                                      .arg(config.virtualSize.height()));
+        display.insert("position", QString("%1,%2")
+                                       .arg(config.position.x())
+                                       .arg(config.position.y()));
+        displays.append(display);
+    }
+
+    object.insert("displays", displays);
+    object.insert("cost", CostToJson(result.layout));
+    return object;
+}
+
+/**
+ * Generates a profile script for every machine inventory found in
+ * @a inventoryDir using all available cores, and writes the scripts and a
+ * summary.json file to @a outputDir.
+ *
+ * \returns The number of machines for which a profile could not be generated,
+ *          or -1 if the directories are not valid
+ */
+int BatchGenerateProfiles(const QString &inventoryDir, const QString &outputDir,
+                          const BatchPolicy &policy)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Check input directory
+    if (!QDir(inventoryDir).exists())
+    {
+        qWarning() << Q_FUNC_INFO << "Directory" << inventoryDir << "does not exist";
+        return -1;
+    }
+
+    // Create output directory
+    QDir dir(outputDir);
+    if (!dir.exists() && !dir.mkpath("."))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot create directory" << outputDir;
+        return -1;
+    }
+
+    // Get inventories
+    const QList<BatchJob> jobs = FindInventories(inventoryDir);
+    const QString outputPath = dir.absolutePath();
+
+    // Process every inventory in the global thread pool
+    QVector<BatchResult> results(jobs.count());
+    BatchResult *data = results.data();
+    QThreadPool *pool = QThreadPool::globalInstance();
+    for (int i = 0; i < jobs.count(); ++i)
+        pool->start(new BatchTask(jobs.at(i), policy, outputPath, &data[i]));
+    pool->waitForDone();
+
+    // Create summary
+    int failed = 0;
+    int skipped = 0;
+    QJsonArray machines;
+    for (int i = 0; i < results.count(); ++i)
+    {
+        if (results.at(i).status == "error")
+            ++failed;
+        else if (results.at(i).status == "skipped")
+            ++skipped;
+
+        machines.append(ResultToJson(results.at(i)));
+    }
+
+    QJsonObject policyJson;
+    policyJson.insert("scale", policy.scale > 0 ? QJsonValue(policy.scale)
+                                                : QJsonValue("auto"));
+    policyJson.insert("method",
+                      policy.textDpi ? "text" : (policy.xrandrScale ? "scale" : "mode"));
+    policyJson.insert("refresh", policy.refresh);
+
+    QJsonObject summary;
+    summary.insert("policy", policyJson);
+    summary.insert("total", jobs.count());
+    summary.insert("ok", jobs.count() - failed - skipped);
+    summary.insert("skipped", skipped);
+    summary.insert("failed", failed);
+    summary.insert("elapsedMs", timer.elapsed());
+    summary.insert("machines", machines);
+
+    // Write summary
+    QFile file(outputPath + "/summary.json");
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << "for writing!";
+        return -1;
+    }
+    file.write(QJsonDocument(summary).toJson());
+    file.close();
+
+    // Report results
+    qDebug() << "Processed" << jobs.count() << "inventories in" << timer.elapsed()
+             << "ms:" << failed << "failed," << skipped << "skipped.";
+
+    return failed;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FLEET_BATCH_H
+#define FLEET_BATCH_H
+
+#include <QString>
+
+#include "DisplayLayout.h"
+#include "DisplayInventory.h"
+
+/**
+ * Options used to generate the profiles of every machine, a scale or refresh
+ * rate of 0 means that it is obtained from each display.
+ */
+struct BatchPolicy
+{
+    qreal scale = 0;
+    qreal refresh = 0;
+    bool xrandrScale = false;
+    bool textDpi = false;
+    bool preDesktop = false;
+};
+
+extern qreal BatchAutomaticScale(const OutputInfo &output, const ModeInfo &mode);
+extern DisplayLayout BatchComputeLayout(const ScreenInventory &inventory,
+                                        const BatchPolicy &policy);
+extern int BatchGenerateProfiles(const QString &inventoryDir, const QString &outputDir,
+                                 const BatchPolicy &policy);
+
+#endif
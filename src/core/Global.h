@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef GLOBAL_H
+#define GLOBAL_H
+
+#include <QDir>
+#include <QString>
+
+/**
+ * Define application information
+ */
+static const QString APP_VERSION = "1.4";
+static const QString APP_NAME = "HiDPI Fixer";
+
+/**
+ * Defines the folder in which the HiDPI-Fixer scripts are stored
+ */
+static const QString SCRIPTS_HOME = QString("%1/.hidpi-fixer").arg(QDir::homePath());
+
+/**
+ * Defines the script that restores the display state saved before the last
+ * test or apply, and the seconds to wait before reverting a test
+ */
+static const QString REVERT_SCRIPT = SCRIPTS_HOME + "/revert";
+static const int REVERT_TIMEOUT = 15;
+
+/**
+ * Defines the folder of the profile store and how often (in ms) the
+ * power source (and the displays, if the backend is not notified of their
+ * changes) are checked when watching for hotplug events
+ */
+static const QString PROFILES_HOME = SCRIPTS_HOME + "/profiles";
+static const int PROFILES_WATCH_INTERVAL = 2000;
+
+/**
+ * Defines the folder in which the kernel reports the AC adapters and
+ * batteries, used to select the power-saving variant of the profiles
+ */
+static const QString POWER_SUPPLY_LOCATION = "/sys/class/power_supply";
+
+/**
+ * Defines the folder of the user application launchers, the cache of the
+ * .desktop file index, the key that identifies the launchers created by
+ * HiDPI Fixer and the command that runs the apps that cannot scale
+ */
+static const QString APPLICATIONS_LOCATION
+    = QString("%1/.local/share/applications").arg(QDir::homePath());
+static const QString APPLICATIONS_INDEX = SCRIPTS_HOME + "/applications.json";
+static const QString LAUNCHER_MARKER = "X-HiDPI-Fixer";
+static const QString RUN_SCALED = "run_scaled";
+
+/**
+ * Defines the file location and name pattern for startup scripts
+ */
+static const QString AUTOSTART_PATTERN = "HiDPI-Fixer_";
+static const QString AUTOSTART_LOCATION
+    = QString("%1/.config/autostart").arg(QDir::homePath());
+
+/**
+ * Defines the X session startup file and the marker used to identify the
+ * lines added by HiDPI Fixer
+ */
+static const QString XPROFILE_MARKER = "[HiDPI-Fixer]";
+static const QString XPROFILE_LOCATION = QString("%1/.xprofile").arg(QDir::homePath());
+
+/**
+ * Defines the login shell profile, in which the toolkit environment is set
+ */
+static const QString SHELL_PROFILE_LOCATION
+    = QString("%1/.profile").arg(QDir::homePath());
+
+#endif
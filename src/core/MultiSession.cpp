@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <QRegExp>
+#include <QVector>
+#include <QRunnable>
+#include <QJsonArray>
+#include <QThreadPool>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+
+#include <algorithm>
+
+#include "Preflight.h"
+#include "MultiSession.h"
+#include "DisplayBackend.h"
+
+/**
+ * Outcome of configuring a single X display
+ */
+struct SessionResult
+{
+    QString display;
+    QString status;
+    QString error;
+    DisplayLayout layout;
+    qint64 elapsedMs = 0;
+};
+
+/**
+ * Returns the backend specification used for the X @a display. Sessions
+ * recorded (or replayed) through HIDPI_FIXER_BACKEND use one file for each
+ * display (e.g. "session.json.1" for ":1"), so that the threads never write
+ * to the same file.
+ */
+static QString SessionBackendSpec(const QString &display)
+{
+    const QString spec = qEnvironmentVariable("HIDPI_FIXER_BACKEND");
+    if (!spec.startsWith("record:") && !spec.startsWith("replay:"))
+        return spec;
+
+    QString suffix = display;
+    suffix.replace(QRegExp("[^A-Za-z0-9.-]+"), "_");
+    if (suffix.startsWith('_'))
+        suffix.remove(0, 1);
+
+    return QString("%1.%2").arg(spec).arg(suffix);
+}
+
+/**
+ * Returns the X resources that make X11 apps render text and cursors at the
+ * scaling factor of the @a layout, they are removed again at factor 1
+ */
+static QMap<QString, QString> SessionResources(const DisplayLayout &layout)
+{
+    const bool scaled = layout.factor > 1;
+    QMap<QString, QString> resources;
+    resources.insert("Xft.dpi", scaled ? QString::number(96 * layout.factor) : QString());
+    resources.insert("Xcursor.size",
+                     scaled ? QString::number(24 * layout.factor) : QString());
+    return resources;
+}
+
+/**
+ * Probes and configures a single X display through its own backend (and
+ * thus its own X connection), each task writes to its own result, so tasks
+ * can run in parallel without locking.
+ */
+class SessionTask : public QRunnable
+{
+public:
+    SessionTask(const QString &display, const MultiSessionOptions &options,
+                SessionResult *result)
+        : m_display(display)
+        , m_options(options)
+        , m_result(result)
+    {
+    }
+
+    void run() override
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        m_result->display = m_display;
+        DisplayBackend *backend = BackendCreate(SessionBackendSpec(m_display), m_display);
+        if (backend)
+            configure(backend);
+        else
+            fail("Cannot create the display backend");
+
+        delete backend;
+
+        m_result->elapsedMs = timer.elapsed();
+    }
+
+private:
+    void configure(DisplayBackend *backend)
+    {
+        // Probe displays
+        ScreenInventory inventory;
+        if (!backend->inventory(inventory))
+        {
+            fail(backend->errorString());
+            return;
+        }
+
+        // Arrange displays
+        bool xrandrScale = m_options.policy.xrandrScale;
+        m_result->layout = BatchComputeLayout(inventory, m_options.policy);
+        if (m_result->layout.displays.isEmpty())
+        {
+            fail("No connected displays found");
+            return;
+        }
+
+        // Scale factor is 1, use the native modes (this undoes the scaling
+        // applied before to the same session)
+        if (m_result->layout.factor == 1)
+        {
+            m_result->layout = LayoutNative(m_result->layout);
+            xrandrScale = true;
+        }
+
+        // Only validate the layout
+        if (m_options.dryRun)
+        {
+            const QStringList errors
+                = PreflightValidate(m_result->layout, inventory, xrandrScale);
+            if (!errors.isEmpty())
+                fail(errors.join("; "));
+            else
+                m_result->status = "valid";
+
+            return;
+        }
+
+        // Validate and apply the layout
+        if (!backend->configure(m_result->layout, xrandrScale))
+        {
+            fail(QString(backend->errorString()).replace('\n', "; "));
+            return;
+        }
+
+        // Scale text and cursors of X11 apps through the same X connection,
+        // the GNOME scaling factor used by the generated scripts belongs to
+        // the desktop of each session
+        if (!backend->setResources(SessionResources(m_result->layout)))
+        {
+            fail(backend->errorString());
+            return;
+        }
+
+        m_result->status = "ok";
+    }
+
+    void fail(const QString &error)
+    {
+        m_result->status = "error";
+        m_result->error = error;
+    }
+
+private:
+    QString m_display;
+    MultiSessionOptions m_options;
+    SessionResult *m_result;
+};
+
+/**
+ * Returns the local X displays (e.g. ":0", ":1") that have a socket in
+ * /tmp/.X11-unix, sorted by display number
+ */
+QStringList MultiSessionFindDisplays()
+{
+    QList<int> numbers;
+    const QStringList sockets
+        = QDir("/tmp/.X11-unix").entryList(QStringList("X*"), QDir::System);
+    for (int i = 0; i < sockets.count(); ++i)
+    {
+        bool ok = false;
+        const int number = sockets.at(i).mid(1).toInt(&ok);
+        if (ok)
+            numbers.append(number);
+    }
+
+    std::sort(numbers.begin(), numbers.end());
+
+    QStringList displays;
+    for (int i = 0; i < numbers.count(); ++i)
+        displays.append(QString(":%1").arg(numbers.at(i)));
+
+    return displays;
+}
+
+/**
+ * Converts the given @a result to a JSON object for the report
+ */
+static QJsonObject ResultToJson(const SessionResult &result)
+{
+    QJsonObject object;
+    object.insert("display", result.display);
+    object.insert("status", result.status);
+    object.insert("elapsedMs", result.elapsedMs);
+    if (!result.error.isEmpty())
+        object.insert("error", result.error);
+
+    // Only report the layout if it was computed
+    if (result.layout.displays.isEmpty())
+        return object;
+
+    QJsonArray outputs;
+    for (int i = 0; i < result.layout.displays.count(); ++i)
+    {
+        const DisplayConfig &config = result.layout.displays.at(i);
+
+        QJsonObject output;
+        output.insert("output", config.name);
+        output.insert("mode", QString("%1x%2")
+                                  .arg(config.mode.width())
+                                  .arg(config.mode.height()));
+        output.insert("scale", config.scale);
+        output.insert("virtual", QString("%1x%2")
+                                     .arg(config.virtualSize.width())
+                                     .arg(config.virtualSize.height()));
+        outputs.append(output);
+    }
+
+    object.insert("factor", result.layout.factor);
+    object.insert("framebuffer", QString("%1x%2")
+                                     .arg(result.layout.framebuffer.width())
+                                     .arg(result.layout.framebuffer.height()));
+    object.insert("outputs", outputs);
+    return object;
+}
+
+/**
+ * Probes and configures every X display in @a displays (e.g. ":1",
+ * "host:10.0") from a bounded pool of worker threads, so that many sessions
+ * can be scaled at once without spawning a chain of processes for each one.
+ * The result of each display is printed, and written to the JSON report if
+ * one is given in the @a options.
+ *
+ * \returns The number of displays that could not be configured, or -1 if
+ *          the report cannot be written
+ */
+int MultiSessionApply(const QStringList &displays, const MultiSessionOptions &options)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Configure every display in a pool of its own, so that the number of
+    // simultaneous X connections is bounded
+    QThreadPool pool;
+    if (options.jobs > 0)
+        pool.setMaxThreadCount(options.jobs);
+
+    QVector<SessionResult> results(displays.count());
+    SessionResult *data = results.data();
+    for (int i = 0; i < displays.count(); ++i)
+        pool.start(new SessionTask(displays.at(i), options, &data[i]));
+    pool.waitForDone();
+
+    // Print results and create report
+    int failed = 0;
+    QJsonArray array;
+    for (int i = 0; i < results.count(); ++i)
+    {
+        const SessionResult &result = results.at(i);
+        if (result.status == "error")
+            ++failed;
+
+        qDebug() << qPrintable(result.display) << qPrintable(result.status)
+                 << qPrintable(QString("(%1 ms)").arg(result.elapsedMs))
+                 << qPrintable(result.error);
+        array.append(ResultToJson(result));
+    }
+
+    qDebug() << "Processed" << displays.count() << "displays in" << timer.elapsed()
+             << "ms:" << failed << "failed.";
+
+    // Nothing else to do if no report was requested
+    if (options.report.isEmpty())
+        return failed;
+
+    QJsonObject policy;
+    policy.insert("scale", options.policy.scale > 0 ? QJsonValue(options.policy.scale)
+                                                    : QJsonValue("auto"));
+    policy.insert("method", options.policy.xrandrScale ? "scale" : "mode");
+    policy.insert("refresh", options.policy.refresh);
+
+    QJsonObject report;
+    report.insert("policy", policy);
+    report.insert("dryRun", options.dryRun);
+    report.insert("jobs", pool.maxThreadCount());
+    report.insert("total", displays.count());
+    report.insert("ok", displays.count() - failed);
+    report.insert("failed", failed);
+    report.insert("elapsedMs", timer.elapsed());
+    report.insert("displays", array);
+
+    // Write report
+    QFile file(options.report);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << "for writing!";
+        return -1;
+    }
+    file.write(QJsonDocument(report).toJson());
+    file.close();
+
+    return failed;
+}
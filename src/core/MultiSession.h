@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MULTI_SESSION_H
+#define MULTI_SESSION_H
+
+#include <QString>
+#include <QStringList>
+
+#include "FleetBatch.h"
+
+/**
+ * Options used to configure many X displays at once. Each display uses the
+ * preferred mode of its outputs and the scale of the @c policy, at most
+ * @c jobs displays are configured at the same time (0 for one per core).
+ * With @c dryRun the displays are probed and validated, but not changed.
+ */
+struct MultiSessionOptions
+{
+    BatchPolicy policy;
+    int jobs = 0;
+    bool dryRun = false;
+    QString report;
+};
+
+extern QStringList MultiSessionFindDisplays();
+extern int MultiSessionApply(const QStringList &displays,
+                             const MultiSessionOptions &options);
+
+#endif
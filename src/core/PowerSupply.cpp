@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+
+#include "PowerSupply.h"
+
+/**
+ * Returns the trimmed contents of the @a attribute of the power supply at
+ * @a path (e.g. "type" or "online"), or an empty string if it cannot be read
+ */
+static QString ReadAttribute(const QString &path, const QString &attribute)
+{
+    QFile file(path + "/" + attribute);
+    if (!file.open(QFile::ReadOnly))
+        return QString();
+
+    const QString value = QString::fromLatin1(file.readAll()).trimmed();
+    file.close();
+    return value;
+}
+
+/**
+ * Returns the power source reported by the kernel in @a path (usually
+ * /sys/class/power_supply). A mains adapter or USB-C port that is online
+ * means AC. Only machines with a system battery can run on battery, they do
+ * if it is discharging or their mains adapter is offline (offline USB ports
+ * are ignored, they are usually empty).
+ */
+PowerSource PowerGetSource(const QString &path)
+{
+    bool online = false;
+    bool hasMains = false;
+    bool hasBattery = false;
+    bool discharging = false;
+
+    const QStringList supplies = QDir(path).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (int i = 0; i < supplies.count(); ++i)
+    {
+        const QString supply = path + "/" + supplies.at(i);
+        const QString type = ReadAttribute(supply, "type");
+
+        // Any online adapter powers the machine
+        if (type == "Mains" || type == "USB")
+        {
+            hasMains |= type == "Mains";
+            online |= ReadAttribute(supply, "online") == "1";
+        }
+
+        // Ignore peripheral batteries (mice, keyboards...)
+        else if (type == "Battery" && ReadAttribute(supply, "scope") != "Device")
+        {
+            hasBattery = true;
+            discharging |= ReadAttribute(supply, "status") == "Discharging";
+        }
+    }
+
+    // Desktops (and machines whose batteries cannot be read)
+    if (!hasBattery)
+        return online ? PowerAc : PowerUnknown;
+
+    if (!online && (discharging || hasMains))
+        return PowerBattery;
+
+    return PowerAc;
+}
+
+/**
+ * Returns a human readable name of the given power @a source
+ */
+QString PowerSourceName(const PowerSource source)
+{
+    switch (source)
+    {
+        case PowerAc:
+            return "AC";
+        case PowerBattery:
+            return "battery";
+        default:
+            return "unknown";
+    }
+}
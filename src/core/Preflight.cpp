@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QRect>
+#include <QVector>
+
+#include "Cvt.h"
+#include "Edid.h"
+#include "Preflight.h"
+
+/**
+ * Returns the output of the @a inventory with the given @a name, or
+ * @c nullptr if not found
+ */
+static const OutputInfo *FindOutput(const ScreenInventory &inventory, const QString &name)
+{
+    for (int i = 0; i < inventory.outputs.count(); ++i)
+    {
+        if (inventory.outputs.at(i).name == name)
+            return &inventory.outputs.at(i);
+    }
+
+    return nullptr;
+}
+
+/**
+ * Tries to assign a free CRTC to the output at @a index (and re-assigns the
+ * CRTCs of the previous outputs if needed), returns @c true on success
+ */
+static bool AssignCrtc(const QList<QList<int>> &crtcs, const int index,
+                       QVector<bool> &visited, QVector<int> &owners)
+{
+    for (int i = 0; i < crtcs.at(index).count(); ++i)
+    {
+        const int crtc = crtcs.at(index).at(i);
+        if (crtc < 0 || crtc >= owners.count() || visited[crtc])
+            continue;
+
+        visited[crtc] = true;
+        if (owners[crtc] < 0 || AssignCrtc(crtcs, owners[crtc], visited, owners))
+        {
+            owners[crtc] = index;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Checks the timings of the mode sent to the @a output against the range
+ * limits of its EDID, the problems found are appended to @a errors
+ */
+static void CheckTimings(const OutputInfo &output, const qreal pixelClock,
+                         const qreal hSync, const qreal vRefresh, QStringList &errors)
+{
+    const EdidRangeLimits limits = EdidGetRangeLimits(output.edid);
+    if (!limits.valid)
+        return;
+
+    if (limits.maxPixelClock > 0 && pixelClock > limits.maxPixelClock)
+    {
+        errors.append(QString("%1: pixel clock of %2 MHz exceeds the maximum of %3 MHz")
+                          .arg(output.name)
+                          .arg(pixelClock, 0, 'f', 2)
+                          .arg(limits.maxPixelClock));
+    }
+
+    if (hSync > 0 && (hSync < limits.minHRate || hSync > limits.maxHRate))
+    {
+        errors.append(QString("%1: horizontal rate of %2 kHz is outside of %3-%4 kHz")
+                          .arg(output.name)
+                          .arg(hSync, 0, 'f', 2)
+                          .arg(limits.minHRate)
+                          .arg(limits.maxHRate));
+    }
+
+    if (vRefresh > 0 && (vRefresh < limits.minVRate || vRefresh > limits.maxVRate))
+    {
+        errors.append(QString("%1: refresh rate of %2 Hz is outside of %3-%4 Hz")
+                          .arg(output.name)
+                          .arg(vRefresh, 0, 'f', 2)
+                          .arg(limits.minVRate)
+                          .arg(limits.maxVRate));
+    }
+}
+
+/**
+ * Returns the framebuffer that the @a layout needs once applied. Displays of
+ * an incomplete layout keep their current position (or are placed at the
+ * right of the screen if they are off), and the framebuffer must still
+ * contain the outputs that are not part of the layout.
+ */
+static QSize RequiredFramebuffer(const DisplayLayout &layout,
+                                 const ScreenInventory &inventory)
+{
+    if (layout.complete)
+        return layout.framebuffer;
+
+    QRect area;
+    QStringList names;
+    for (int i = 0; i < layout.displays.count(); ++i)
+    {
+        const DisplayConfig &display = layout.displays.at(i);
+        const OutputInfo *output = FindOutput(inventory, display.name);
+        QPoint position(inventory.current.width(), 0);
+        if (output && output->geometry.isValid())
+            position = output->geometry.topLeft();
+
+        names.append(display.name);
+        area |= QRect(position, display.virtualSize);
+    }
+
+    for (int i = 0; i < inventory.outputs.count(); ++i)
+    {
+        const OutputInfo &output = inventory.outputs.at(i);
+        if (!names.contains(output.name) && output.geometry.isValid())
+            area |= output.geometry;
+    }
+
+    return QSize(area.right() + 1, area.bottom() + 1);
+}
+
+/**
+ * Checks that the X server and the displays described by the @a inventory
+ * can drive the given @a layout before any mode is set. The framebuffer is
+ * checked against the screen limits, the number of displays against the
+ * available CRTCs and each generated mode (or --scale/--panning target)
+ * against the modes, refresh rates, pixel clock and timing ranges of its
+ * output.
+ *
+ * Returns a list with the problems found, which is empty if the layout can
+ * be applied safely.
+ */
+QStringList PreflightValidate(const DisplayLayout &layout,
+                              const ScreenInventory &inventory, const bool xrandrScale)
+{
+    QStringList errors;
+
+    // Check framebuffer against the screen limits reported by the X server
+    const QSize fb = RequiredFramebuffer(layout, inventory);
+    if (inventory.maximum.isValid()
+        && (fb.width() > inventory.maximum.width()
+            || fb.height() > inventory.maximum.height()))
+    {
+        errors.append(QString("Framebuffer %1x%2 exceeds the maximum screen size %3x%4")
+                          .arg(fb.width())
+                          .arg(fb.height())
+                          .arg(inventory.maximum.width())
+                          .arg(inventory.maximum.height()));
+    }
+    else if (fb.width() < inventory.minimum.width()
+             || fb.height() < inventory.minimum.height())
+    {
+        errors.append(QString("Framebuffer %1x%2 is smaller than the minimum screen "
+                              "size %3x%4")
+                          .arg(fb.width())
+                          .arg(fb.height())
+                          .arg(inventory.minimum.width())
+                          .arg(inventory.minimum.height()));
+    }
+
+    // Check each display
+    int crtcCount = 0;
+    bool crtcsKnown = true;
+    QList<QList<int>> crtcs;
+    for (int i = 0; i < layout.displays.count(); ++i)
+    {
+        const DisplayConfig &display = layout.displays.at(i);
+
+        // Check that the output exists
+        const OutputInfo *output = FindOutput(inventory, display.name);
+        if (!output || !output->connected)
+        {
+            errors.append(QString("%1: output is not connected").arg(display.name));
+            continue;
+        }
+
+        // Register CRTCs that can drive the output
+        crtcs.append(output->crtcs);
+        crtcsKnown &= !output->crtcs.isEmpty();
+        for (int j = 0; j < output->crtcs.count(); ++j)
+            crtcCount = qMax(crtcCount, output->crtcs.at(j) + 1);
+
+        // xrandr --scale: the output must support the mode at the requested
+        // refresh rate (any rate if none was requested)
+        if (xrandrScale)
+        {
+            bool sizeFound = false;
+            const ModeInfo *mode = nullptr;
+            for (int j = 0; j < output->modes.count() && !mode; ++j)
+            {
+                const ModeInfo &candidate = output->modes.at(j);
+                if (candidate.size != display.mode)
+                    continue;
+
+                sizeFound = true;
+                if (display.refresh <= 0
+                    || qAbs(candidate.refresh - display.refresh) < 0.5)
+                    mode = &candidate;
+            }
+
+            if (!sizeFound)
+            {
+                errors.append(QString("%1: mode %2x%3 is not supported")
+                                  .arg(display.name)
+                                  .arg(display.mode.width())
+                                  .arg(display.mode.height()));
+                continue;
+            }
+
+            if (!mode)
+            {
+                errors.append(QString("%1: mode %2x%3 is not supported at %4 Hz")
+                                  .arg(display.name)
+                                  .arg(display.mode.width())
+                                  .arg(display.mode.height())
+                                  .arg(display.refresh));
+                continue;
+            }
+
+            CheckTimings(*output, mode->pixelClock, 0, mode->refresh, errors);
+        }
+
+        // Custom mode: the CVT timings must be accepted by the display
+        else
+        {
+            const QSize size = display.virtualSize;
+            const CvtTimings timings
+                = CvtComputeTimings(size.width(), size.height(), display.refresh);
+            if (timings.clock <= 0)
+            {
+                errors.append(QString("%1: cannot generate a mode for %2x%3")
+                                  .arg(display.name)
+                                  .arg(display.virtualSize.width())
+                                  .arg(display.virtualSize.height()));
+                continue;
+            }
+
+            CheckTimings(*output, timings.clock / 1000.0, timings.hSync, timings.vRefresh,
+                         errors);
+        }
+    }
+
+    // Check that every display gets its own CRTC (skipped if the inventory
+    // does not report CRTCs)
+    if (crtcsKnown && crtcCount > 0)
+    {
+        QVector<int> owners(crtcCount, -1);
+        for (int i = 0; i < crtcs.count(); ++i)
+        {
+            QVector<bool> visited(crtcCount, false);
+            if (!AssignCrtc(crtcs, i, visited, owners))
+            {
+                errors.append(QString("Not enough CRTCs to drive %1 displays")
+                                  .arg(crtcs.count()));
+                break;
+            }
+        }
+    }
+
+    return errors;
+}
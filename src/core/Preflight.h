@@ -20,15 +20,16 @@
  * THE SOFTWARE.
  */
 
-#ifndef XRANDR_BRIDGE_H
-#define XRANDR_BRIDGE_H
+#ifndef PREFLIGHT_H
+#define PREFLIGHT_H
 
 #include <QStringList>
 
-extern QStringList XrandrGetAvailableDisplays();
-extern QStringList XrandrGetAvailableResolutions(const int display);
+#include "DisplayLayout.h"
+#include "DisplayInventory.h"
 
-extern QString CvtGetModeline(const int w, const int h);
-extern QString CvtGetResolutionName(const QString modeline);
+extern QStringList PreflightValidate(const DisplayLayout &layout,
+                                     const ScreenInventory &inventory,
+                                     const bool xrandrScale);
 
 #endif
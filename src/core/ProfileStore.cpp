@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QCryptographicHash>
+
+#include <algorithm>
+
+#include "Edid.h"
+#include "ScriptFile.h"
+#include "ProfileStore.h"
+
+/**
+ * Creates a profile store in the given directory, the index is not read
+ * until load() is called
+ */
+ProfileStore::ProfileStore(const QString &path)
+    : m_path(path)
+{
+}
+
+/**
+ * Reads the profile index, a missing index is treated as an empty store
+ */
+bool ProfileStore::load()
+{
+    m_names.clear();
+    m_profiles.clear();
+
+    // Nothing to read if the index does not exist
+    QFile file(m_path + "/index.json");
+    if (!file.exists())
+        return true;
+
+    // Read index
+    if (!file.open(QFile::ReadOnly))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << "for reading!";
+        return false;
+    }
+    const QJsonObject index = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+
+    // Register each profile
+    const QStringList fingerprints = index.keys();
+    for (int i = 0; i < fingerprints.count(); ++i)
+    {
+        const QJsonObject object = index.value(fingerprints.at(i)).toObject();
+
+        ProfileInfo info;
+        info.fingerprint = fingerprints.at(i);
+        info.name = object.value("name").toString();
+        info.modified = QDateTime::fromString(object.value("modified").toString(),
+                                              Qt::ISODate);
+        info.powerSaving = object.value("powerSaving").toBool();
+
+        const QJsonArray outputs = object.value("outputs").toArray();
+        for (int j = 0; j < outputs.count(); ++j)
+            info.outputs.append(outputs.at(j).toString());
+
+        const QJsonArray monitors = object.value("monitors").toArray();
+        for (int j = 0; j < monitors.count(); ++j)
+            info.monitors.append(monitors.at(j).toString());
+
+        // Older indexes may contain the same name twice
+        if (m_names.contains(info.name))
+            info.name = QString("%1 [%2]").arg(info.name).arg(info.fingerprint);
+
+        m_profiles.insert(info.fingerprint, info);
+        m_names.insert(info.name, info.fingerprint);
+    }
+
+    return true;
+}
+
+/**
+ * Writes the profile index
+ */
+bool ProfileStore::save() const
+{
+    // Create index
+    QJsonObject index;
+    for (auto it = m_profiles.constBegin(); it != m_profiles.constEnd(); ++it)
+    {
+        QJsonObject object;
+        object.insert("name", it.value().name);
+        object.insert("modified", it.value().modified.toString(Qt::ISODate));
+        object.insert("powerSaving", it.value().powerSaving);
+        object.insert("outputs", QJsonArray::fromStringList(it.value().outputs));
+        object.insert("monitors", QJsonArray::fromStringList(it.value().monitors));
+        index.insert(it.key(), object);
+    }
+
+    // Create directory if needed
+    QDir dir(m_path);
+    if (!dir.exists())
+        dir.mkpath(".");
+
+    // Write index (replaced atomically, so that it never points to missing
+    // or partially written scripts)
+    QSaveFile file(m_path + "/index.json");
+    if (!file.open(QFile::WriteOnly))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << "for writing!";
+        return false;
+    }
+    file.write(QJsonDocument(index).toJson());
+    if (!file.commit())
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot write" << file.fileName();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Returns every profile of the store, sorted by name
+ */
+QList<ProfileInfo> ProfileStore::profiles() const
+{
+    QList<ProfileInfo> list = m_profiles.values();
+    std::sort(list.begin(), list.end(), [](const ProfileInfo &a, const ProfileInfo &b) {
+        return a.name < b.name;
+    });
+
+    return list;
+}
+
+/**
+ * Returns @c true if there is a profile for the given @a fingerprint
+ */
+bool ProfileStore::contains(const QString &fingerprint) const
+{
+    return m_profiles.contains(fingerprint);
+}
+
+/**
+ * Returns the profile of the given @a fingerprint
+ */
+ProfileInfo ProfileStore::profile(const QString &fingerprint) const
+{
+    return m_profiles.value(fingerprint);
+}
+
+/**
+ * Returns the fingerprint of the given @a profile, which may be either a
+ * fingerprint or a profile name, or an empty string if not found
+ */
+QString ProfileStore::find(const QString &profile) const
+{
+    if (m_profiles.contains(profile))
+        return profile;
+
+    return m_names.value(profile);
+}
+
+/**
+ * Returns the location of the given @a variant of the script of the given
+ * @a fingerprint
+ */
+QString ProfileStore::scriptPath(const QString &fingerprint,
+                                 const ProfileVariant variant) const
+{
+    if (variant == ProfilePowerSaving)
+        return QString("%1/%2-battery.sh").arg(m_path).arg(fingerprint);
+
+    return QString("%1/%2.sh").arg(m_path).arg(fingerprint);
+}
+
+/**
+ * Saves the @a script of the profile described by @a info (replacing the
+ * previous profile of the same fingerprint) and updates the index. If the
+ * @a powerSavingScript is empty, the profile uses @a script on battery too.
+ *
+ * If another profile already has the same name (e.g. the same monitor model
+ * connected to a different dock), the fingerprint is appended to the name,
+ * so that every name selects a single profile.
+ */
+bool ProfileStore::insert(const ProfileInfo &info, const QString &script,
+                          const QString &powerSavingScript)
+{
+    // Create directory if needed
+    QDir dir(m_path);
+    if (!dir.exists())
+        dir.mkpath(".");
+
+    // Write scripts before the index that points to them (and remove a stale
+    // power-saving variant)
+    const QString powerSavingPath = scriptPath(info.fingerprint, ProfilePowerSaving);
+    if (!ScriptSave(scriptPath(info.fingerprint), script))
+        return false;
+    if (powerSavingScript.isEmpty())
+        QFile::remove(powerSavingPath);
+    else if (!ScriptSave(powerSavingPath, powerSavingScript))
+        return false;
+
+    // Replace previous profile (and its name)
+    if (m_profiles.contains(info.fingerprint))
+        m_names.remove(m_profiles.value(info.fingerprint).name);
+
+    ProfileInfo profile = info;
+    if (m_names.contains(profile.name))
+        profile.name = QString("%1 [%2]").arg(info.name).arg(info.fingerprint);
+
+    profile.modified = QDateTime::currentDateTime();
+    profile.powerSaving = !powerSavingScript.isEmpty();
+    m_profiles.insert(profile.fingerprint, profile);
+    m_names.insert(profile.name, profile.fingerprint);
+    return save();
+}
+
+/**
+ * Deletes the profile of the given @a fingerprint and its script
+ */
+bool ProfileStore::remove(const QString &fingerprint)
+{
+    if (!m_profiles.contains(fingerprint))
+        return false;
+
+    QFile::remove(scriptPath(fingerprint));
+    QFile::remove(scriptPath(fingerprint, ProfilePowerSaving));
+    m_names.remove(m_profiles.value(fingerprint).name);
+    m_profiles.remove(fingerprint);
+    return save();
+}
+
+/**
+ * Returns the fingerprint of the displays connected in the @a inventory,
+ * obtained from the output names and the hash of their EDIDs (outputs
+ * without EDID only contribute their name). The fingerprint does not depend
+ * on the order of the outputs.
+ */
+QString ProfileFingerprint(const ScreenInventory &inventory)
+{
+    // Describe each connected output
+    QStringList entries;
+    const QList<OutputInfo> outputs = InventoryConnectedOutputs(inventory);
+    for (int i = 0; i < outputs.count(); ++i)
+    {
+        const QByteArray edid
+            = QCryptographicHash::hash(outputs.at(i).edid, QCryptographicHash::Sha1);
+        const QString hash = QString::fromLatin1(edid.toHex());
+        entries.append(QString("%1=%2").arg(outputs.at(i).name).arg(hash));
+    }
+
+    // Nothing connected
+    if (entries.isEmpty())
+        return QString();
+
+    // Hash the sorted list of outputs
+    entries.sort();
+    const QByteArray hash = QCryptographicHash::hash(entries.join('\n').toUtf8(),
+                                                     QCryptographicHash::Sha1);
+    return QString::fromLatin1(hash.toHex().left(16));
+}
+
+/**
+ * Returns the fingerprint, outputs and monitor names of the displays
+ * connected in the @a inventory, the profile is named after them
+ */
+ProfileInfo ProfileDescribe(const ScreenInventory &inventory)
+{
+    ProfileInfo info;
+    info.fingerprint = ProfileFingerprint(inventory);
+
+    // Register outputs and monitor names
+    QStringList parts;
+    const QList<OutputInfo> outputs = InventoryConnectedOutputs(inventory);
+    for (int i = 0; i < outputs.count(); ++i)
+    {
+        const QString monitor = EdidGetMonitorName(outputs.at(i).edid);
+        info.outputs.append(outputs.at(i).name);
+        info.monitors.append(monitor);
+
+        if (monitor.isEmpty())
+            parts.append(outputs.at(i).name);
+        else
+            parts.append(QString("%1 (%2)").arg(outputs.at(i).name).arg(monitor));
+    }
+
+    // Name profile after its displays
+    info.name = parts.join(" + ");
+    return info;
+}
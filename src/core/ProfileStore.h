@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PROFILE_STORE_H
+#define PROFILE_STORE_H
+
+#include <QHash>
+#include <QString>
+#include <QDateTime>
+#include <QStringList>
+
+#include "DisplayInventory.h"
+
+/**
+ * Profile saved for a specific set of connected displays, identified by the
+ * fingerprint of their output names and EDIDs. A profile may also carry a
+ * cheaper power-saving script, used while the machine runs on battery.
+ */
+struct ProfileInfo
+{
+    QString fingerprint;
+    QString name;
+    QStringList outputs;
+    QStringList monitors;
+    QDateTime modified;
+    bool powerSaving = false;
+};
+
+/**
+ * Scripts of a profile
+ */
+enum ProfileVariant
+{
+    ProfilePerformance,
+    ProfilePowerSaving,
+};
+
+/**
+ * Stores the profile scripts of every display topology (e.g. laptop alone,
+ * laptop + office dock) together with an index that maps each fingerprint
+ * to its profile, so that the profile of the connected displays is found in
+ * constant time on login or hotplug.
+ */
+class ProfileStore
+{
+public:
+    ProfileStore(const QString &path);
+
+    bool load();
+    bool save() const;
+
+    QList<ProfileInfo> profiles() const;
+    bool contains(const QString &fingerprint) const;
+    ProfileInfo profile(const QString &fingerprint) const;
+    QString find(const QString &profile) const;
+    QString scriptPath(const QString &fingerprint,
+                       const ProfileVariant variant = ProfilePerformance) const;
+
+    bool insert(const ProfileInfo &info, const QString &script,
+                const QString &powerSavingScript = QString());
+    bool remove(const QString &fingerprint);
+
+private:
+    QString m_path;
+    QHash<QString, QString> m_names;
+    QHash<QString, ProfileInfo> m_profiles;
+};
+
+extern QString ProfileFingerprint(const ScreenInventory &inventory);
+extern ProfileInfo ProfileDescribe(const ScreenInventory &inventory);
+
+#endif
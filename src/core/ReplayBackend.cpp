@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QFile>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+
+#include "ReplayBackend.h"
+
+/**
+ * Returns the given @a list as a JSON array of strings
+ */
+static QJsonArray ToJsonArray(const QStringList &list)
+{
+    QJsonArray array;
+    for (int i = 0; i < list.count(); ++i)
+        array.append(list.at(i));
+
+    return array;
+}
+
+/**
+ * Returns the given X @a resources as "name: value" lines (or "name:" for the
+ * resources that are removed), used as the arguments of setResources calls
+ */
+static QStringList ResourceLines(const QMap<QString, QString> &resources)
+{
+    QStringList lines;
+    for (auto it = resources.constBegin(); it != resources.constEnd(); ++it)
+    {
+        if (it.value().isEmpty())
+            lines.append(QString("%1:").arg(it.key()));
+        else
+            lines.append(QString("%1: %2").arg(it.key()).arg(it.value()));
+    }
+
+    return lines;
+}
+
+/**
+ * Records the calls made to @a backend (taking ownership of it) into the
+ * session file at @a path, the first line of the file names the backend
+ */
+RecordingBackend::RecordingBackend(DisplayBackend *backend, const QString &path)
+    : m_file(path)
+    , m_backend(backend)
+{
+    Q_ASSERT(backend);
+
+    if (!m_file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << path << "for writing!";
+        return;
+    }
+
+    QJsonObject header;
+    header.insert("backend", m_backend->name());
+    m_file.write(QJsonDocument(header).toJson(QJsonDocument::Compact) + '\n');
+    m_file.flush();
+}
+
+/**
+ * Deletes the recorded backend
+ */
+RecordingBackend::~RecordingBackend()
+{
+    delete m_backend;
+}
+
+/**
+ * Returns the name of the backend
+ */
+QString RecordingBackend::name() const
+{
+    return QString("record:%1").arg(m_backend->name());
+}
+
+/**
+ * Reads the inventory from the recorded backend
+ */
+bool RecordingBackend::inventory(ScreenInventory &inventory)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = m_backend->inventory(inventory);
+    const qint64 nsecs = timer.nsecsElapsed();
+
+    QJsonObject event;
+    event.insert("call", "inventory");
+    if (ok)
+        event.insert("inventory", InventoryToJson(inventory));
+
+    return record(event, ok, nsecs);
+}
+
+/**
+ * Creates a mode with the recorded backend
+ */
+bool RecordingBackend::createMode(const QString &output, const QString &modeline)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = m_backend->createMode(output, modeline);
+    const qint64 nsecs = timer.nsecsElapsed();
+
+    QJsonObject event;
+    event.insert("call", "createMode");
+    event.insert("arguments", ToJsonArray(QStringList { output, modeline }));
+    return record(event, ok, nsecs);
+}
+
+/**
+ * Applies a layout with the recorded backend
+ */
+bool RecordingBackend::applyLayout(const DisplayLayout &layout, const bool xrandrScale)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = m_backend->applyLayout(layout, xrandrScale);
+    const qint64 nsecs = timer.nsecsElapsed();
+
+    QJsonObject event;
+    event.insert("call", "applyLayout");
+    event.insert("arguments", ToJsonArray(LayoutGetXrandrArguments(layout, xrandrScale)));
+    return record(event, ok, nsecs);
+}
+
+/**
+ * Sets the X resources with the recorded backend
+ */
+bool RecordingBackend::setResources(const QMap<QString, QString> &resources)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = m_backend->setResources(resources);
+    const qint64 nsecs = timer.nsecsElapsed();
+
+    QJsonObject event;
+    event.insert("call", "setResources");
+    event.insert("arguments", ToJsonArray(ResourceLines(resources)));
+    return record(event, ok, nsecs);
+}
+
+/**
+ * Waits for changes with the recorded backend (waits are not recorded)
+ */
+bool RecordingBackend::waitForChange(const int timeout)
+{
+    return m_backend->waitForChange(timeout);
+}
+
+/**
+ * Adds the result and duration of a call to the @a event and appends it to
+ * the session file (flushed right away, so that it survives crashes)
+ */
+bool RecordingBackend::record(QJsonObject event, const bool ok, const qint64 nsecs)
+{
+    event.insert("ok", ok);
+    event.insert("elapsedMs", nsecs / 1000000.0);
+    if (!ok)
+    {
+        event.insert("error", m_backend->errorString());
+        setErrorString(m_backend->errorString());
+    }
+
+    if (m_file.isOpen())
+    {
+        m_file.write(QJsonDocument(event).toJson(QJsonDocument::Compact) + '\n');
+        m_file.flush();
+    }
+
+    return ok;
+}
+
+/**
+ * Loads the session file at @a path, which contains one JSON object per line:
+ * the backend that was recorded, followed by each call
+ */
+ReplayBackend::ReplayBackend(const QString &path)
+    : m_valid(false)
+    , m_position(0)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << path << "for reading!";
+        setErrorString(QString("Cannot open session %1").arg(path));
+        return;
+    }
+
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    file.close();
+
+    for (int i = 0; i < lines.count(); ++i)
+    {
+        if (lines.at(i).trimmed().isEmpty())
+            continue;
+
+        const QJsonDocument document = QJsonDocument::fromJson(lines.at(i));
+        if (!document.isObject())
+        {
+            setErrorString(QString("Invalid session %1 (line %2)").arg(path).arg(i + 1));
+            return;
+        }
+
+        if (document.object().contains("call"))
+            m_events.append(document.object());
+    }
+
+    m_valid = true;
+}
+
+/**
+ * Returns @c true if the session file was loaded
+ */
+bool ReplayBackend::isValid() const
+{
+    return m_valid;
+}
+
+/**
+ * Returns the name of the backend
+ */
+QString ReplayBackend::name() const
+{
+    return "replay";
+}
+
+/**
+ * Returns the recorded inventory
+ */
+bool ReplayBackend::inventory(ScreenInventory &inventory)
+{
+    QJsonObject event;
+    if (!next("inventory", QStringList(), event))
+        return false;
+
+    inventory = InventoryFromJson(event.value("inventory").toObject());
+    return true;
+}
+
+/**
+ * Returns the recorded result of creating a mode
+ */
+bool ReplayBackend::createMode(const QString &output, const QString &modeline)
+{
+    QJsonObject event;
+    return next("createMode", QStringList { output, modeline }, event);
+}
+
+/**
+ * Returns the recorded result of applying a layout
+ */
+bool ReplayBackend::applyLayout(const DisplayLayout &layout, const bool xrandrScale)
+{
+    QJsonObject event;
+    return next("applyLayout", LayoutGetXrandrArguments(layout, xrandrScale), event);
+}
+
+/**
+ * Returns the recorded result of setting the X resources
+ */
+bool ReplayBackend::setResources(const QMap<QString, QString> &resources)
+{
+    QJsonObject event;
+    return next("setResources", ResourceLines(resources), event);
+}
+
+/**
+ * Reads the next recorded @a event and checks that it matches the given
+ * @a call and @a arguments
+ *
+ * \returns The recorded result of the call
+ */
+bool ReplayBackend::next(const QString &call, const QStringList &arguments,
+                         QJsonObject &event)
+{
+    // Check that there are events left
+    if (m_position >= m_events.count())
+    {
+        setErrorString(QString("Unexpected call to %1, the session has ended").arg(call));
+        return false;
+    }
+
+    // Check that the call matches the recorded one
+    event = m_events.at(m_position++).toObject();
+    if (event.value("call").toString() != call
+        || event.value("arguments").toArray() != ToJsonArray(arguments))
+    {
+        setErrorString(QString("Unexpected call to %1, the session expects %2")
+                           .arg(call)
+                           .arg(event.value("call").toString()));
+        return false;
+    }
+
+    // Return recorded result
+    if (!event.value("ok").toBool())
+    {
+        setErrorString(event.value("error").toString());
+        return false;
+    }
+
+    return true;
+}
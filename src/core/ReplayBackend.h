@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef REPLAY_BACKEND_H
+#define REPLAY_BACKEND_H
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include "DisplayBackend.h"
+
+/**
+ * Display backend that forwards every call to another backend and saves the
+ * calls, their results and their duration to a session file (one JSON object
+ * per line, so that each call is appended as soon as it returns).
+ */
+class RecordingBackend : public DisplayBackend
+{
+public:
+    RecordingBackend(DisplayBackend *backend, const QString &path);
+    ~RecordingBackend() override;
+
+    QString name() const override;
+    bool inventory(ScreenInventory &inventory) override;
+    bool createMode(const QString &output, const QString &modeline) override;
+    bool applyLayout(const DisplayLayout &layout, const bool xrandrScale) override;
+    bool setResources(const QMap<QString, QString> &resources) override;
+    bool waitForChange(const int timeout) override;
+
+private:
+    bool record(QJsonObject event, const bool ok, const qint64 nsecs);
+
+private:
+    QFile m_file;
+    DisplayBackend *m_backend;
+};
+
+/**
+ * Display backend that plays back a session saved by RecordingBackend, the
+ * calls must be made in the same order and with the same arguments.
+ */
+class ReplayBackend : public DisplayBackend
+{
+public:
+    explicit ReplayBackend(const QString &path);
+
+    bool isValid() const;
+
+    QString name() const override;
+    bool inventory(ScreenInventory &inventory) override;
+    bool createMode(const QString &output, const QString &modeline) override;
+    bool applyLayout(const DisplayLayout &layout, const bool xrandrScale) override;
+    bool setResources(const QMap<QString, QString> &resources) override;
+
+private:
+    bool next(const QString &call, const QStringList &arguments, QJsonObject &event);
+
+private:
+    bool m_valid;
+    int m_position;
+    QJsonArray m_events;
+};
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "ScriptFile.h"
+
+/**
+ * Writes the @a script to the file at @a path (creating its directory if
+ * needed) and makes it executable by its owner. The script is written to a
+ * temporary file that replaces the previous one only if everything was
+ * written, so that a crash never leaves a truncated script to be executed.
+ */
+bool ScriptSave(const QString &path, const QString &script)
+{
+    // Create directory if needed
+    QDir dir(QFileInfo(path).absolutePath());
+    if (!dir.exists())
+        dir.mkpath(".");
+
+    // Write script
+    QSaveFile file(path);
+    if (!file.open(QFile::WriteOnly))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << path << "for writing!";
+        return false;
+    }
+
+    file.write(script.toUtf8());
+    if (!file.commit())
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot write" << path;
+        return false;
+    }
+
+    // Make script executable (without spawning a chmod process)
+    return QFile::setPermissions(path, QFile::permissions(path) | QFile::ExeOwner
+                                           | QFile::ExeUser);
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <QSaveFile>
+#include <QStringList>
+#include <QDirIterator>
+#include <QCoreApplication>
+
+#include "Global.h"
+#include "SessionHook.h"
+
+/**
+ * Replaces the lines added by HiDPI Fixer to the file at @a path with the
+ * given @a block (removing them if the block is empty). The rest of the file
+ * is kept byte-for-byte, and the new contents are written to a temporary
+ * file that replaces the original one only if everything was written, so
+ * that the login scripts of the user are never left half-written.
+ */
+static bool UpdateFile(const QString &path, const QStringList &block)
+{
+    // Read current file contents (if any)
+    QString contents;
+    QFile file(path);
+    if (file.exists())
+    {
+        if (!file.open(QFile::ReadOnly))
+        {
+            qWarning() << Q_FUNC_INFO << "Cannot open" << path << "for reading!";
+            return false;
+        }
+
+        contents = QString::fromUtf8(file.readAll());
+        file.close();
+    }
+
+    // Skip lines created by HiDPI Fixer
+    bool skipped = false;
+    bool changed = false;
+    QStringList lines;
+    const QStringList original = contents.split('\n');
+    for (int i = 0; i < original.count(); ++i)
+    {
+        const QString &line = original.at(i);
+        if (line.contains(XPROFILE_MARKER))
+        {
+            skipped = true;
+            changed = true;
+            continue;
+        }
+
+        // Older versions only marked the comment above the Qt exports
+        if (skipped
+            && (line.startsWith("export QT_AUTO_SCREEN_SCALE_FACTOR=")
+                || line.startsWith("export QT_SCALE_FACTOR=")))
+            continue;
+
+        skipped = false;
+        lines.append(line);
+    }
+
+    // Nothing to remove or add, do not touch the file
+    if (!changed && block.isEmpty())
+        return true;
+
+    // Append the new block at the end of the file
+    contents = lines.join('\n');
+    if (!block.isEmpty())
+    {
+        if (!contents.isEmpty() && !contents.endsWith('\n'))
+            contents.append('\n');
+
+        contents.append(block.join('\n') + "\n");
+    }
+
+    // Replace the file atomically
+    QSaveFile output(path);
+    if (!output.open(QFile::WriteOnly))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << path << "for writing!";
+        return false;
+    }
+
+    output.write(contents.toUtf8());
+    if (!output.commit())
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot write" << path;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Returns the location of the HiDPI Fixer executable, AppImages are mounted
+ * in a different directory each time, so the location of the image is used
+ */
+QString SessionGetProgram()
+{
+    const QString appImage = qEnvironmentVariable("APPIMAGE");
+    if (!appImage.isEmpty())
+        return appImage;
+
+    return QCoreApplication::applicationFilePath();
+}
+
+/**
+ * Registers HiDPI Fixer with the given @a arguments (e.g. "--switch auto") in
+ * ~/.xprofile, so that it runs when the X session starts, before the window
+ * manager and the desktop are loaded. Hooks registered before are removed.
+ */
+bool SessionHookInstall(const QStringList &arguments)
+{
+    // Run the program only if it still exists
+    const QString hook
+        = QString("[ -x \"%1\" ] && \"%1\" %2 >/dev/null 2>&1 # %3")
+              .arg(SessionGetProgram())
+              .arg(arguments.join(' '))
+              .arg(XPROFILE_MARKER);
+
+    return UpdateFile(XPROFILE_LOCATION, QStringList(hook));
+}
+
+/**
+ * Removes every ~/.xprofile hook created by HiDPI Fixer
+ */
+bool SessionHookRemove()
+{
+    return UpdateFile(XPROFILE_LOCATION, QStringList());
+}
+
+/**
+ * Creates (or replaces) the autostart launcher with the given @a name, which
+ * runs HiDPI Fixer with the given @a arguments when the desktop starts
+ */
+bool SessionAutostartInstall(const QString &name, const QString &title,
+                             const QStringList &arguments)
+{
+    // Create autostart folder if not present
+    QDir dir(AUTOSTART_LOCATION);
+    if (!dir.exists())
+        dir.mkpath(".");
+
+    // Set launcher data
+    const QString data = QString("[Desktop Entry]\n"
+                                 "Type=Application\n"
+                                 "Exec=\"%1\" %2\n"
+                                 "Hidden=false\n"
+                                 "NoDisplay=false\n"
+                                 "X-GNOME-Autostart-enabled=true\n"
+                                 "Name=%3\n"
+                                 "Comment=Created by HiDPI-Fixer\n")
+                             .arg(SessionGetProgram())
+                             .arg(arguments.join(' '))
+                             .arg(title);
+
+    // Write launcher
+    const QString path = AUTOSTART_LOCATION + "/" + AUTOSTART_PATTERN + name + ".desktop";
+    QSaveFile file(path);
+    if (!file.open(QFile::WriteOnly))
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open" << path << "for writing!";
+        return false;
+    }
+
+    file.write(data.toUtf8());
+    return file.commit();
+}
+
+/**
+ * Returns the names of the autostart launchers created by HiDPI Fixer
+ */
+QStringList SessionAutostartList()
+{
+    QStringList names;
+    QDirIterator it(AUTOSTART_LOCATION);
+    while (it.hasNext())
+    {
+        it.next();
+        const QString name = it.fileName();
+        if (!name.startsWith(AUTOSTART_PATTERN) || !name.endsWith(".desktop"))
+            continue;
+
+        names.append(name.mid(AUTOSTART_PATTERN.length(),
+                              name.length() - AUTOSTART_PATTERN.length() - 8));
+    }
+
+    return names;
+}
+
+/**
+ * Removes the autostart launchers created by HiDPI Fixer, except the ones
+ * whose names are listed in @a keep
+ */
+bool SessionAutostartRemove(const QStringList &keep)
+{
+    bool ok = true;
+    const QStringList names = SessionAutostartList();
+    for (int i = 0; i < names.count(); ++i)
+    {
+        if (!keep.contains(names.at(i)))
+            ok &= QFile::remove(AUTOSTART_LOCATION + "/" + AUTOSTART_PATTERN
+                                + names.at(i) + ".desktop");
+    }
+
+    return ok;
+}
+
+/**
+ * Replaces the toolkit environment exported by HiDPI Fixer in ~/.profile
+ * with the given @a exports (e.g. "export QT_FONT_DPI=96"), so that saving
+ * a new configuration never leaves stale or duplicated variables behind.
+ */
+bool SessionEnvironmentInstall(const QStringList &exports)
+{
+    // Mark every line, so that they can be removed later
+    QStringList block;
+    if (!exports.isEmpty())
+    {
+        block.append(QString("# Adapt Qt and GTK apps to HiDPI config %1")
+                         .arg(XPROFILE_MARKER));
+        for (int i = 0; i < exports.count(); ++i)
+            block.append(QString("%1 # %2").arg(exports.at(i)).arg(XPROFILE_MARKER));
+    }
+
+    return UpdateFile(SHELL_PROFILE_LOCATION, block);
+}
+
+/**
+ * Removes the toolkit environment exported by HiDPI Fixer in ~/.profile
+ */
+bool SessionEnvironmentRemove()
+{
+    return UpdateFile(SHELL_PROFILE_LOCATION, QStringList());
+}
@@ -0,0 +1,607 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QDebug>
+#include <QProcess>
+#include <QStringList>
+#include <QDirIterator>
+
+#include "Global.h"
+#include "FleetBatch.h"
+#include "DesktopIndex.h"
+#include "PowerSupply.h"
+#include "SessionHook.h"
+#include "MultiSession.h"
+#include "ProfileStore.h"
+#include "DisplayBackend.h"
+#include "DisplaySnapshot.h"
+#include "StartupVerifications.h"
+
+/**
+ * Reads the options of the --batch command from @a args and generates the
+ * profiles of every captured inventory.
+ *
+ * \returns The exit code of the application
+ */
+static int RunBatch(const QStringList &args)
+{
+    bool valid = true;
+    BatchPolicy policy;
+    QStringList paths;
+
+    // Read policy options and input/output directories
+    for (int i = 0; i < args.count(); ++i)
+    {
+        const QString option = args.at(i).toLower();
+        const bool hasValue = i + 1 < args.count();
+
+        if (option == "--scale" && hasValue)
+        {
+            const QString value = args.at(++i).toLower();
+            if (value != "auto")
+            {
+                bool ok = false;
+                policy.scale = value.toDouble(&ok);
+                valid &= ok;
+            }
+        }
+
+        else if (option == "--method" && hasValue)
+        {
+            const QString method = args.at(++i).toLower();
+            policy.xrandrScale = method == "scale";
+            policy.textDpi = method == "text";
+            valid &= method == "scale" || method == "mode" || method == "text";
+        }
+
+        else if (option == "--refresh" && hasValue)
+        {
+            bool ok = false;
+            policy.refresh = args.at(++i).toDouble(&ok);
+            valid &= ok;
+        }
+
+        else if (option == "--pre-desktop")
+            policy.preDesktop = true;
+
+        else if (option.startsWith("--"))
+        {
+            qDebug() << "[Error] Invalid batch option" << qPrintable(args.at(i));
+            return EXIT_FAILURE;
+        }
+
+        else
+            paths.append(args.at(i));
+    }
+
+    // Validate arguments
+    if (!valid || paths.count() != 2 || (policy.scale != 0 && policy.scale < 1)
+        || policy.refresh < 0)
+    {
+        qDebug() << "Usage: hidpi-fixer --batch <inventories> <output> [--scale <n|auto>]"
+                    " [--method <mode|scale|text>] [--refresh <hz>] [--pre-desktop]";
+        return EXIT_FAILURE;
+    }
+
+    // Generate profiles
+    const int failed = BatchGenerateProfiles(paths.at(0), paths.at(1), policy);
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Reads the options of the --sessions command from @a args and configures
+ * every given X display (or every local display if "all" is given).
+ *
+ * \returns The exit code of the application
+ */
+static int RunSessions(const QStringList &args)
+{
+    bool valid = true;
+    QStringList displays;
+    MultiSessionOptions options;
+
+    // Read options and display targets
+    for (int i = 0; i < args.count(); ++i)
+    {
+        const QString option = args.at(i).toLower();
+        const bool hasValue = i + 1 < args.count();
+
+        if (option == "--scale" && hasValue)
+        {
+            const QString value = args.at(++i).toLower();
+            if (value != "auto")
+            {
+                bool ok = false;
+                options.policy.scale = value.toDouble(&ok);
+                valid &= ok;
+            }
+        }
+
+        else if (option == "--method" && hasValue)
+        {
+            const QString method = args.at(++i).toLower();
+            options.policy.xrandrScale = method == "scale";
+            valid &= method == "scale" || method == "mode";
+        }
+
+        else if (option == "--refresh" && hasValue)
+        {
+            bool ok = false;
+            options.policy.refresh = args.at(++i).toDouble(&ok);
+            valid &= ok;
+        }
+
+        else if (option == "--jobs" && hasValue)
+            options.jobs = args.at(++i).toInt();
+
+        else if (option == "--report" && hasValue)
+            options.report = args.at(++i);
+
+        else if (option == "--dry-run")
+            options.dryRun = true;
+
+        else if (option.startsWith("--"))
+        {
+            qDebug() << "[Error] Invalid sessions option" << qPrintable(args.at(i));
+            return EXIT_FAILURE;
+        }
+
+        else if (option == "all")
+            displays.append(MultiSessionFindDisplays());
+
+        else
+            displays.append(args.at(i));
+    }
+
+    // Validate arguments
+    displays.removeDuplicates();
+    if (!valid || displays.isEmpty()
+        || (options.policy.scale != 0 && options.policy.scale < 1)
+        || options.policy.refresh < 0 || options.jobs < 0)
+    {
+        qDebug() << "Usage: hidpi-fixer --sessions <displays|all> [--scale <n|auto>]"
+                    " [--method <mode|scale>] [--refresh <hz>] [--jobs <n>]"
+                    " [--dry-run] [--report <file>]";
+        return EXIT_FAILURE;
+    }
+
+    // Configure displays
+    const int failed = MultiSessionApply(displays, options);
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Returns the variant of the profile with the given @a fingerprint that
+ * suits the current power @a source
+ */
+static ProfileVariant GetVariant(const ProfileStore &store, const QString &fingerprint,
+                                 const PowerSource source)
+{
+    if (source == PowerBattery && store.profile(fingerprint).powerSaving)
+        return ProfilePowerSaving;
+
+    return ProfilePerformance;
+}
+
+/**
+ * Saves the current display state (so that it can be restored with
+ * --revert) and runs the given @a variant of the script of the profile with
+ * the given \a fingerprint.
+ *
+ * \returns The exit code of the profile script
+ */
+static int ApplyProfile(DisplayBackend *backend, const ProfileStore &store,
+                        const QString &fingerprint, const ProfileVariant variant)
+{
+    // Save display state
+    DisplaySnapshot snapshot;
+    if (!SnapshotCapture(backend, snapshot)
+        || !SnapshotSaveRevertScript(snapshot, REVERT_SCRIPT))
+        qDebug() << "[Warning] Cannot save the current display state";
+
+    // Run profile script
+    qDebug() << "Applying profile" << qPrintable(store.profile(fingerprint).name)
+             << (variant == ProfilePowerSaving ? "(power-saving)" : "(performance)");
+    const QString script = store.scriptPath(fingerprint, variant);
+    const int exitCode = QProcess::execute("bash", { script });
+    if (exitCode != 0)
+        qDebug() << "[Error] Profile script returned exit code" << exitCode;
+
+    return exitCode;
+}
+
+/**
+ * Prints the saved profiles, the profile of the connected displays is
+ * marked with an asterisk.
+ *
+ * \returns The exit code of the application
+ */
+static int ListProfiles()
+{
+    // Read profile index
+    ProfileStore store(PROFILES_HOME);
+    if (!store.load())
+        return EXIT_FAILURE;
+
+    // Get fingerprint of the connected displays
+    ScreenInventory inventory;
+    DisplayBackend *backend = BackendCreate(QString(), QString());
+    const QString current = backend && backend->inventory(inventory)
+        ? ProfileFingerprint(inventory)
+        : QString();
+    delete backend;
+
+    // Print profiles
+    const QList<ProfileInfo> profiles = store.profiles();
+    for (int i = 0; i < profiles.count(); ++i)
+    {
+        const ProfileInfo &info = profiles.at(i);
+        qDebug() << (info.fingerprint == current ? "*" : " ")
+                 << qPrintable(info.fingerprint) << qPrintable(info.name)
+                 << (info.powerSaving ? "[power-saving variant]" : "");
+    }
+
+    // Notify user if there are no profiles for the current displays
+    if (!current.isEmpty() && !store.contains(current))
+        qDebug() << "No profile saved for the connected displays"
+                 << qPrintable(QString("(%1)").arg(current));
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Applies the given \a profile (name or fingerprint), the profile of the
+ * connected displays is used if \a profile is empty or "auto".
+ *
+ * \returns The exit code of the application
+ */
+static int SwitchProfile(const QString &profile)
+{
+    // Read profile index
+    ProfileStore store(PROFILES_HOME);
+    if (!store.load())
+        return EXIT_FAILURE;
+
+    // Find profile
+    QString fingerprint;
+    DisplayBackend *backend = BackendCreate(QString(), QString());
+    if (!backend)
+        return EXIT_FAILURE;
+
+    if (profile.isEmpty() || profile == "auto")
+    {
+        ScreenInventory inventory;
+        if (backend->inventory(inventory))
+            fingerprint = ProfileFingerprint(inventory);
+    }
+    else
+        fingerprint = store.find(profile);
+
+    // Profile not found
+    if (!store.contains(fingerprint))
+    {
+        qDebug() << "[Error] Profile not found, type --profiles to list them";
+        delete backend;
+        return EXIT_FAILURE;
+    }
+
+    // Apply the variant that suits the power source
+    const PowerSource source = PowerGetSource(POWER_SUPPLY_LOCATION);
+    const ProfileVariant variant = GetVariant(store, fingerprint, source);
+    const int exitCode = ApplyProfile(backend, store, fingerprint, variant);
+    delete backend;
+    return exitCode == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Waits for changes of the connected displays and of the power source and
+ * applies the matching profile whenever they change (e.g. when docking or
+ * undocking a laptop, or when unplugging its AC adapter). The native backend
+ * is notified of display changes by the X server, so the displays are only
+ * probed again after a change, the power source is read from sysfs after
+ * each notification or timeout. This function only returns if the display
+ * backend stops working.
+ *
+ * \returns The exit code of the application
+ */
+static int WatchProfiles()
+{
+    ProfileStore store(PROFILES_HOME);
+    DisplayBackend *backend = BackendCreate(QString(), QString());
+    if (!backend)
+        return EXIT_FAILURE;
+
+    // The profile of the displays connected when the watcher starts is
+    // applied by the login hook (--switch), only react to later changes
+    ScreenInventory initial;
+    if (!backend->inventory(initial))
+    {
+        qDebug() << "[Error]" << qPrintable(backend->errorString());
+        delete backend;
+        return EXIT_FAILURE;
+    }
+
+    QString current = ProfileFingerprint(initial);
+    PowerSource currentSource = PowerGetSource(POWER_SUPPLY_LOCATION);
+
+    qDebug() << "Watching display and power changes, press Ctrl+C to quit";
+    bool changed = backend->waitForChange(PROFILES_WATCH_INTERVAL);
+    while (true)
+    {
+        // Get fingerprint of the connected displays (if they may have changed)
+        QString fingerprint = current;
+        if (changed)
+        {
+            ScreenInventory inventory;
+            if (!backend->inventory(inventory))
+            {
+                qDebug() << "[Error]" << qPrintable(backend->errorString());
+                break;
+            }
+
+            fingerprint = ProfileFingerprint(inventory);
+        }
+
+        // Apply profile if the displays or the power source changed (the
+        // index is read again, because profiles may be saved while watching)
+        const PowerSource source = PowerGetSource(POWER_SUPPLY_LOCATION);
+        if (fingerprint != current && !fingerprint.isEmpty())
+        {
+            current = fingerprint;
+            currentSource = source;
+            if (store.load() && store.contains(fingerprint))
+                ApplyProfile(backend, store, fingerprint,
+                             GetVariant(store, fingerprint, source));
+            else
+                qDebug() << "No profile saved for the connected displays"
+                         << qPrintable(QString("(%1)").arg(fingerprint));
+        }
+
+        // Only switch variants if the profile has a power-saving script
+        else if (source != currentSource && !current.isEmpty())
+        {
+            qDebug() << "Power source changed to" << qPrintable(PowerSourceName(source));
+            store.load();
+            const ProfileVariant previous = GetVariant(store, current, currentSource);
+            const ProfileVariant variant = GetVariant(store, current, source);
+            currentSource = source;
+            if (store.contains(current) && variant != previous)
+                ApplyProfile(backend, store, current, variant);
+        }
+
+        changed = backend->waitForChange(PROFILES_WATCH_INTERVAL);
+    }
+
+    delete backend;
+    return EXIT_FAILURE;
+}
+
+/**
+ * Reads the given user \a args and takes appropiate actions. This function
+ * does not depend on the GUI, so that it can run before (or without) creating
+ * a \c QApplication, the platform checks are done by the GUI itself.
+ *
+ * \param args The arguments provided by the user or the system
+ * \param exitCode Set to the exit code of the executed command
+ * \returns \c true If the GUI should be executed, \c false to quit directly
+ *          after the command output
+ */
+bool StartupVerifications(int argc, char **argv, int &exitCode)
+{
+    exitCode = EXIT_SUCCESS;
+
+    // Construct arguments
+    QStringList arguments;
+    for (int i = 1; i < argc; ++i)
+        arguments.append(QString::fromLocal8Bit(argv[i]));
+
+    // Get command, make it lower case (for easier handling)
+    QString command;
+    if (!arguments.isEmpty())
+        command = arguments.first().toLower();
+
+    // Delete everything created by HiDPI Fixer
+    if (command == "-u" || command == "--uninstall")
+    {
+        // Delete location of scripts
+        QDir home(SCRIPTS_HOME);
+        if (home.exists())
+        {
+            if (home.removeRecursively())
+                qDebug() << "Folder" << SCRIPTS_HOME << "removed successfully.";
+            else
+                qDebug() << "[Error] Failed to remove folder" << SCRIPTS_HOME
+                         << "you will need to manually remove it.";
+        }
+
+        // Delete startup launchers
+        QDir dir;
+        QDirIterator it(AUTOSTART_LOCATION);
+        while (it.hasNext())
+        {
+            it.next();
+            if (it.fileName().contains(AUTOSTART_PATTERN)
+                && it.fileName().endsWith(".desktop"))
+            {
+                if (dir.remove(it.filePath()))
+                    qDebug() << "Removed" << qPrintable(it.filePath()) << ".";
+                else
+                    qDebug() << "[Error] Failed to remove" << qPrintable(it.fileName())
+                             << ".";
+            }
+        }
+
+        // Delete X session startup hooks
+        if (SessionHookRemove())
+            qDebug() << "Removed HiDPI Fixer hooks from" << qPrintable(XPROFILE_LOCATION)
+                     << ".";
+        else
+            qDebug() << "[Error] Failed to edit" << qPrintable(XPROFILE_LOCATION)
+                     << "you will need to manually remove the lines marked with"
+                     << qPrintable(XPROFILE_MARKER);
+
+        // Delete application launchers
+        if (LauncherRemoveAll())
+            qDebug() << "Removed HiDPI Fixer launchers from"
+                     << qPrintable(APPLICATIONS_LOCATION) << ".";
+        else
+            qDebug() << "[Error] Failed to remove some launchers from"
+                     << qPrintable(APPLICATIONS_LOCATION) << "you will need to manually"
+                     << "remove the files that contain" << qPrintable(LAUNCHER_MARKER);
+
+        // Delete toolkit environment
+        if (SessionEnvironmentRemove())
+            qDebug() << "Removed HiDPI Fixer variables from"
+                     << qPrintable(SHELL_PROFILE_LOCATION) << ".";
+        else
+            qDebug() << "[Error] Failed to edit" << qPrintable(SHELL_PROFILE_LOCATION)
+                     << "you will need to manually remove the lines marked with"
+                     << qPrintable(XPROFILE_MARKER);
+
+        // Reset GNOME scaling factor, font DPI, text scaling factor and cursor size
+        QProcess process;
+        const QString commands = LayoutGetTextDpiReset()
+            + "gsettings reset org.gnome.desktop.interface scaling-factor\n";
+        process.start("bash", QStringList { "-c", commands });
+        process.waitForFinished(3000);
+
+        // Notify user
+        qDebug() << "Uninstall finished, have a nice day!";
+
+        // Quit app
+        return false;
+    }
+
+    // Show application version
+    else if (command == "-v" || command == "--version")
+    {
+        qDebug() << qPrintable(APP_NAME) << "version" << qPrintable(APP_VERSION);
+        qDebug() << "Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>.";
+        qDebug() << "Released under the MIT License.";
+        return false;
+    }
+
+    // Show help menu
+    else if (command == "-h" || command == "--help")
+    {
+        StartupShowHelp();
+        return false;
+    }
+
+    // Restore the display state saved before the last test or apply
+    else if (command == "-r" || command == "--revert")
+    {
+        if (!QFile::exists(REVERT_SCRIPT))
+        {
+            qDebug() << "[Error] No display state has been saved yet";
+            exitCode = EXIT_FAILURE;
+            return false;
+        }
+
+        exitCode = QProcess::execute("bash", { REVERT_SCRIPT });
+        if (exitCode != 0)
+            qDebug() << "[Error] Failed to run" << qPrintable(REVERT_SCRIPT);
+
+        return false;
+    }
+
+    // List saved profiles
+    else if (command == "-p" || command == "--profiles")
+    {
+        exitCode = ListProfiles();
+        return false;
+    }
+
+    // Apply a saved profile
+    else if (command == "-s" || command == "--switch")
+    {
+        exitCode = SwitchProfile(arguments.value(1));
+        return false;
+    }
+
+    // Apply the matching profile when the connected displays change
+    else if (command == "-w" || command == "--watch")
+    {
+        exitCode = WatchProfiles();
+        return false;
+    }
+
+    // Generate profiles for captured display inventories
+    else if (command == "-b" || command == "--batch")
+    {
+        exitCode = RunBatch(arguments.mid(1));
+        return false;
+    }
+
+    // Configure many X displays (e.g. terminal server sessions) at once
+    else if (command == "-m" || command == "--sessions")
+    {
+        exitCode = RunSessions(arguments.mid(1));
+        return false;
+    }
+
+    // Invalid argument, warn user, but run the application
+    else if (!command.isEmpty())
+    {
+        qDebug() << "Warning: Invalid argument " << arguments.join(' ')
+                 << "type --help to show available options.";
+        return true;
+    }
+
+    // So far, so good!
+    return true;
+}
+
+/**
+ * Prints the available command line options
+ */
+void StartupShowHelp()
+{
+    qDebug() << "Usage: hidpi-fixer [options]";
+    qDebug() << "Where options are:";
+    qDebug() << "  -v, --version    Show application version";
+    qDebug() << "  -u, --uninstall  Remove all scripts and startup launchers created "
+                "by HiDPI Fixer";
+    qDebug() << "  -r, --revert     Restore the display state saved before the last "
+                "test or apply";
+    qDebug() << "  -p, --profiles   List the saved profiles";
+    qDebug() << "  -s, --switch [profile]";
+    qDebug() << "                   Apply a saved profile (name or fingerprint), by";
+    qDebug() << "                   default the profile of the connected displays";
+    qDebug() << "                   (its power-saving variant when on battery)";
+    qDebug() << "  -w, --watch      Apply the profile of the connected displays";
+    qDebug() << "                   whenever they change (dock/undock), and its";
+    qDebug() << "                   power-saving variant when running on battery";
+    qDebug() << "                   (use --switch to apply it when starting)";
+    qDebug() << "  -b, --batch <inventories> <output> [policy]";
+    qDebug() << "                   Generate profiles for a directory of captured";
+    qDebug() << "                   xrandr --verbose inventories, the policy options are";
+    qDebug() << "                   --scale <n|auto>, --method <mode|scale|text>,";
+    qDebug() << "                   --refresh <hz> and --pre-desktop";
+    qDebug() << "  -m, --sessions <displays|all> [options]";
+    qDebug() << "                   Configure many X displays at once (e.g. :1 :2),";
+    qDebug() << "                   the options are --scale <n|auto>, --method";
+    qDebug() << "                   <mode|scale>, --refresh <hz>, --jobs <n>,";
+    qDebug() << "                   --dry-run and --report <file>";
+    qDebug() << "  -h, --help       Show this menu";
+}
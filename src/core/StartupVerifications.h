@@ -23,6 +23,7 @@
 #ifndef ARGUMENTS_H
 #define ARGUMENTS_H
 
-extern bool StartupVerifications(int argc, char **argv);
+extern void StartupShowHelp();
+extern bool StartupVerifications(int argc, char **argv, int &exitCode);
 
 #endif
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QProcess>
+
+#include "XRandrBridge.h"
+
+/**
+ * Returns the xrandr arguments needed to talk to the given X @a display,
+ * an empty display name uses the $DISPLAY environment variable
+ */
+static QStringList DisplayArguments(const QString &display)
+{
+    if (display.isEmpty())
+        return QStringList();
+
+    return QStringList { "--display", display };
+}
+
+/**
+ * Runs xrandr with the given @a arguments, waiting up to @a timeout ms for it
+ * to finish. A new process is created for every call, so this function can
+ * be used from several threads at once.
+ */
+static XrandrResult Run(const QStringList &arguments, const int timeout)
+{
+    XrandrResult result;
+    result.arguments = arguments;
+
+    // Start xrandr
+    QProcess process;
+    process.start("xrandr", arguments);
+    if (!process.waitForStarted())
+    {
+        result.error = XrandrFailedToStart;
+        result.errorOutput = process.errorString();
+        return result;
+    }
+
+    // Wait for xrandr to finish (kill it if it hangs)
+    if (!process.waitForFinished(timeout))
+    {
+        process.kill();
+        process.waitForFinished();
+        result.error = XrandrTimedOut;
+    }
+
+    // Get exit status and output
+    else if (process.exitStatus() != QProcess::NormalExit)
+        result.error = XrandrCrashed;
+
+    else if (process.exitCode() != 0)
+        result.error = XrandrExitError;
+
+    result.exitCode = process.exitCode();
+    result.output = QString::fromUtf8(process.readAllStandardOutput());
+    result.errorOutput = QString::fromUtf8(process.readAllStandardError()).trimmed();
+    return result;
+}
+
+/**
+ * Runs xrandr --verbose, the output of the result contains the screen limits,
+ * outputs, modes and EDIDs of the X @a display
+ */
+XrandrResult XrandrGetVerboseOutput(const QString &display)
+{
+    return Run(DisplayArguments(display) << "--verbose", 3000);
+}
+
+/**
+ * Runs xrandr with the given @a arguments on the X @a display
+ */
+XrandrResult XrandrExecute(const QStringList &arguments, const QString &display)
+{
+    return Run(DisplayArguments(display) + arguments, 10000);
+}
+
+/**
+ * Returns a human-readable description of the error of the given @a result,
+ * or an empty string if xrandr finished successfully
+ */
+QString XrandrErrorString(const XrandrResult &result)
+{
+    QString error;
+    const QStringList commandLine = QStringList("xrandr") + result.arguments;
+    const QString command = commandLine.join(' ');
+    switch (result.error)
+    {
+        case XrandrNoError:
+            return QString();
+        case XrandrFailedToStart:
+            error = QString("Cannot run \"%1\"").arg(command);
+            break;
+        case XrandrTimedOut:
+            error = QString("\"%1\" timed out").arg(command);
+            break;
+        case XrandrCrashed:
+            error = QString("\"%1\" crashed").arg(command);
+            break;
+        case XrandrExitError:
+            error = QString("\"%1\" returned exit code %2")
+                        .arg(command)
+                        .arg(result.exitCode);
+            break;
+    }
+
+    // Append the error message of xrandr
+    if (!result.errorOutput.isEmpty())
+        error.append(QString(": %1").arg(result.errorOutput));
+
+    return error;
+}
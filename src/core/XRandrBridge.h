@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef XRANDR_BRIDGE_H
+#define XRANDR_BRIDGE_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * Reasons why an xrandr call can fail
+ */
+enum XrandrError
+{
+    XrandrNoError,
+    XrandrFailedToStart,
+    XrandrTimedOut,
+    XrandrCrashed,
+    XrandrExitError,
+};
+
+/**
+ * Outcome of an xrandr call: error code, exit status and captured output.
+ * Results are plain values, so that xrandr can be called from any thread
+ * and the caller decides how to report the errors.
+ */
+struct XrandrResult
+{
+    XrandrError error = XrandrNoError;
+    int exitCode = 0;
+    QStringList arguments;
+    QString output;
+    QString errorOutput;
+};
+
+extern XrandrResult XrandrGetVerboseOutput(const QString &display);
+extern XrandrResult XrandrExecute(const QStringList &arguments, const QString &display);
+extern QString XrandrErrorString(const XrandrResult &result);
+
+#endif
@@ -0,0 +1,901 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QRect>
+#include <QDebug>
+#include <QPoint>
+#include <QVector>
+
+#include <cstring>
+
+#include "XrandrNativeBackend.h"
+
+#ifdef HAVE_XRANDR
+#    include <sys/select.h>
+#    include <X11/Xlib.h>
+#    include <X11/Xatom.h>
+#    include <X11/extensions/Xrandr.h>
+
+/**
+ * Code of the last X error generated by the requests of the current thread
+ */
+static thread_local int LAST_X_ERROR = 0;
+
+/**
+ * Registers X errors instead of aborting the application (the default
+ * behaviour of Xlib)
+ */
+static int HandleXError(Display *display, XErrorEvent *event)
+{
+    (void)display;
+    LAST_X_ERROR = event->error_code;
+    return 0;
+}
+
+/**
+ * Waits until the X server processes all pending requests and returns
+ * @c true if none of them failed
+ */
+static bool SyncWithoutErrors(Display *display)
+{
+    XSync(display, False);
+    return LAST_X_ERROR == 0;
+}
+
+/**
+ * Returns the refresh rate of the given @a mode
+ */
+static qreal ModeRefresh(const XRRModeInfo *mode)
+{
+    double vTotal = mode->vTotal;
+    if (mode->modeFlags & RR_DoubleScan)
+        vTotal *= 2;
+    if (mode->modeFlags & RR_Interlace)
+        vTotal /= 2;
+
+    if (mode->hTotal == 0 || vTotal == 0)
+        return 0;
+
+    return mode->dotClock / (mode->hTotal * vTotal);
+}
+
+/**
+ * Returns the name used by xrandr for the given CRTC @a rotation
+ */
+static QString RotationName(const Rotation rotation)
+{
+    switch (rotation & 0x0f)
+    {
+        case RR_Rotate_90:
+            return "left";
+        case RR_Rotate_180:
+            return "inverted";
+        case RR_Rotate_270:
+            return "right";
+        default:
+            return "normal";
+    }
+}
+
+/**
+ * Returns the CRTC rotation for the given xrandr rotation @a name
+ */
+static Rotation RotationValue(const QString &name)
+{
+    if (name == "left")
+        return RR_Rotate_90;
+    else if (name == "inverted")
+        return RR_Rotate_180;
+    else if (name == "right")
+        return RR_Rotate_270;
+
+    return RR_Rotate_0;
+}
+
+/**
+ * Returns the mode with the given @a id, or @c nullptr if not found
+ */
+static XRRModeInfo *FindMode(XRRScreenResources *resources, const RRMode id)
+{
+    for (int i = 0; i < resources->nmode; ++i)
+    {
+        if (resources->modes[i].id == id)
+            return &resources->modes[i];
+    }
+
+    return nullptr;
+}
+
+/**
+ * Returns the mode with the given @a name, or @c nullptr if not found
+ */
+static XRRModeInfo *FindMode(XRRScreenResources *resources, const QByteArray &name)
+{
+    for (int i = 0; i < resources->nmode; ++i)
+    {
+        const XRRModeInfo &mode = resources->modes[i];
+        if (QByteArray(mode.name, mode.nameLength) == name)
+            return &resources->modes[i];
+    }
+
+    return nullptr;
+}
+
+/**
+ * Returns the ID of the output with the given @a name, or None if not found
+ */
+static RROutput FindOutput(Display *display, XRRScreenResources *resources,
+                           const QString &name)
+{
+    RROutput id = None;
+    for (int i = 0; i < resources->noutput && id == None; ++i)
+    {
+        XRROutputInfo *info = XRRGetOutputInfo(display, resources, resources->outputs[i]);
+        if (!info)
+            continue;
+
+        if (QString::fromLatin1(info->name, info->nameLen) == name)
+            id = resources->outputs[i];
+
+        XRRFreeOutputInfo(info);
+    }
+
+    return id;
+}
+#endif
+
+/**
+ * Opens a connection to the given X @a display (empty for $DISPLAY)
+ */
+XrandrNativeBackend::XrandrNativeBackend(const QString &display)
+    : m_display(nullptr)
+    , m_notified(false)
+{
+#ifdef HAVE_XRANDR
+    // Initialize Xlib thread support and error handler only once
+    static const bool initialized = [] {
+        XInitThreads();
+        XSetErrorHandler(HandleXError);
+        return true;
+    }();
+    (void)initialized;
+
+    // Open connection
+    const QByteArray name = display.toLocal8Bit();
+    Display *connection = XOpenDisplay(display.isEmpty() ? nullptr : name.constData());
+    if (!connection)
+    {
+        qWarning() << Q_FUNC_INFO << "Cannot open X display" << display;
+        return;
+    }
+
+    // Check that the server supports RandR 1.3 (needed for panning/transforms)
+    int major = 0;
+    int minor = 0;
+    if (!XRRQueryVersion(connection, &major, &minor) || (major == 1 && minor < 3))
+    {
+        qWarning() << Q_FUNC_INFO << "RandR 1.3 is not supported by" << display;
+        XCloseDisplay(connection);
+        return;
+    }
+
+    m_display = connection;
+#else
+    (void)display;
+#endif
+}
+
+/**
+ * Closes the connection to the X display
+ */
+XrandrNativeBackend::~XrandrNativeBackend()
+{
+#ifdef HAVE_XRANDR
+    if (m_display)
+        XCloseDisplay(static_cast<Display *>(m_display));
+#endif
+}
+
+/**
+ * Returns @c true if the backend is connected to an X server with RandR
+ */
+bool XrandrNativeBackend::isValid() const
+{
+    return m_display != nullptr;
+}
+
+/**
+ * Merges the given X @a resources into the RESOURCE_MANAGER property of the
+ * root window (like xrdb -merge), the resources with empty values are
+ * removed
+ */
+bool XrandrNativeBackend::setResources(const QMap<QString, QString> &resources)
+{
+#ifdef HAVE_XRANDR
+    if (!isValid())
+    {
+        setErrorString("Not connected to an X server");
+        return false;
+    }
+
+    // Read the current resources, one "name:\tvalue" line each
+    LAST_X_ERROR = 0;
+    Display *display = static_cast<Display *>(m_display);
+    const Window root = RootWindow(display, 0);
+    QStringList lines;
+    Atom type = None;
+    int format = 0;
+    unsigned long count = 0;
+    unsigned long remaining = 0;
+    unsigned char *data = nullptr;
+    if (XGetWindowProperty(display, root, XA_RESOURCE_MANAGER, 0, 1 << 24, False,
+                           XA_STRING, &type, &format, &count, &remaining, &data)
+            == Success
+        && data)
+    {
+        const QString text = QString::fromUtf8(reinterpret_cast<const char *>(data),
+                                               static_cast<int>(count));
+        lines = text.split('\n', Qt::SkipEmptyParts);
+        XFree(data);
+    }
+
+    // Replace (or remove) the given resources
+    for (auto it = resources.constBegin(); it != resources.constEnd(); ++it)
+    {
+        for (int i = lines.count() - 1; i >= 0; --i)
+        {
+            if (lines.at(i).startsWith(it.key() + ":"))
+                lines.removeAt(i);
+        }
+
+        if (!it.value().isEmpty())
+            lines.append(QString("%1:\t%2").arg(it.key()).arg(it.value()));
+    }
+
+    // Write the resources back
+    const QByteArray value = (lines.join('\n') + '\n').toUtf8();
+    XChangeProperty(display, root, XA_RESOURCE_MANAGER, XA_STRING, 8, PropModeReplace,
+                    reinterpret_cast<const unsigned char *>(value.constData()),
+                    value.size());
+    if (!SyncWithoutErrors(display))
+    {
+        setErrorString(QString("Cannot set X resources (X error %1)").arg(LAST_X_ERROR));
+        return false;
+    }
+
+    return true;
+#else
+    (void)resources;
+    setErrorString("HiDPI Fixer was built without libXrandr");
+    return false;
+#endif
+}
+
+/**
+ * Waits up to @a timeout milliseconds for a RandR screen or output change
+ * notification, returns @c false if the displays did not change
+ */
+bool XrandrNativeBackend::waitForChange(const int timeout)
+{
+#ifdef HAVE_XRANDR
+    if (!isValid())
+        return DisplayBackend::waitForChange(timeout);
+
+    // Ask the X server to notify screen and output changes
+    Display *display = static_cast<Display *>(m_display);
+    if (!m_notified)
+    {
+        XRRSelectInput(display, DefaultRootWindow(display),
+                       RRScreenChangeNotifyMask | RROutputChangeNotifyMask);
+        XFlush(display);
+        m_notified = true;
+    }
+
+    // Sleep on the connection until an event arrives or the timeout expires
+    if (XPending(display) == 0)
+    {
+        const int fd = ConnectionNumber(display);
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(fd, &fds);
+        timeval interval;
+        interval.tv_sec = timeout / 1000;
+        interval.tv_usec = (timeout % 1000) * 1000;
+        select(fd + 1, &fds, nullptr, nullptr, &interval);
+    }
+
+    // Discard the events, the caller reads the inventory again
+    bool changed = false;
+    while (XPending(display) > 0)
+    {
+        XEvent event;
+        XNextEvent(display, &event);
+        changed = true;
+    }
+
+    return changed;
+#else
+    return DisplayBackend::waitForChange(timeout);
+#endif
+}
+
+/**
+ * Returns the name of the backend
+ */
+QString XrandrNativeBackend::name() const
+{
+    return "native";
+}
+
+/**
+ * Reads the screen limits, outputs, modes and EDIDs from the X server
+ */
+bool XrandrNativeBackend::inventory(ScreenInventory &inventory)
+{
+#ifdef HAVE_XRANDR
+    if (!isValid())
+    {
+        setErrorString("Not connected to an X server");
+        return false;
+    }
+
+    LAST_X_ERROR = 0;
+    Display *display = static_cast<Display *>(m_display);
+    const Window root = DefaultRootWindow(display);
+    const int screen = DefaultScreen(display);
+
+    // Get screen limits
+    int minWidth = 0;
+    int minHeight = 0;
+    int maxWidth = 0;
+    int maxHeight = 0;
+    XRRGetScreenSizeRange(display, root, &minWidth, &minHeight, &maxWidth, &maxHeight);
+    inventory = ScreenInventory();
+    inventory.minimum = QSize(minWidth, minHeight);
+    inventory.maximum = QSize(maxWidth, maxHeight);
+    inventory.current
+        = QSize(DisplayWidth(display, screen), DisplayHeight(display, screen));
+
+    // Get screen resources
+    XRRScreenResources *resources = XRRGetScreenResourcesCurrent(display, root);
+    if (!resources)
+    {
+        setErrorString("Cannot get RandR screen resources");
+        return false;
+    }
+
+    // Get each output
+    const RROutput primary = XRRGetOutputPrimary(display, root);
+    const Atom edidAtom = XInternAtom(display, RR_PROPERTY_RANDR_EDID, True);
+    for (int i = 0; i < resources->noutput; ++i)
+    {
+        const RROutput id = resources->outputs[i];
+        XRROutputInfo *output = XRRGetOutputInfo(display, resources, id);
+        if (!output)
+            continue;
+
+        OutputInfo info;
+        info.name = QString::fromLatin1(output->name, output->nameLen);
+        info.connected = output->connection == RR_Connected;
+        info.primary = id == primary;
+        info.physicalSize = QSize(static_cast<int>(output->mm_width),
+                                  static_cast<int>(output->mm_height));
+
+        // Get position and current mode
+        RRMode currentMode = None;
+        if (output->crtc)
+        {
+            XRRCrtcInfo *crtc = XRRGetCrtcInfo(display, resources, output->crtc);
+            if (crtc)
+            {
+                info.geometry = QRect(crtc->x, crtc->y, static_cast<int>(crtc->width),
+                                      static_cast<int>(crtc->height));
+                info.rotation = RotationName(crtc->rotation);
+                currentMode = crtc->mode;
+                XRRFreeCrtcInfo(crtc);
+            }
+
+            // Get panning area
+            XRRPanning *panning = XRRGetPanning(display, resources, output->crtc);
+            if (panning)
+            {
+                info.panning = QRect(panning->left, panning->top,
+                                     static_cast<int>(panning->width),
+                                     static_cast<int>(panning->height));
+                XRRFreePanning(panning);
+            }
+
+            // Get transform matrix
+            XRRCrtcTransformAttributes *attributes = nullptr;
+            if (XRRGetCrtcTransform(display, output->crtc, &attributes) && attributes)
+            {
+                const XTransform &matrix = attributes->currentTransform;
+                for (int row = 0; row < 3; ++row)
+                {
+                    for (int col = 0; col < 3; ++col)
+                        info.transform.append(XFixedToDouble(matrix.matrix[row][col]));
+                }
+
+                XFree(attributes);
+            }
+        }
+
+        // Get the indices of the CRTCs that can drive the output
+        for (int j = 0; j < output->ncrtc; ++j)
+        {
+            for (int k = 0; k < resources->ncrtc; ++k)
+            {
+                if (resources->crtcs[k] == output->crtcs[j])
+                    info.crtcs.append(k);
+            }
+        }
+
+        // Get modes
+        for (int j = 0; j < output->nmode; ++j)
+        {
+            const XRRModeInfo *mode = FindMode(resources, output->modes[j]);
+            if (!mode)
+                continue;
+
+            ModeInfo modeInfo;
+            modeInfo.name = QString::fromLatin1(mode->name, mode->nameLength);
+            modeInfo.id = QString("0x%1").arg(mode->id, 0, 16);
+            modeInfo.size = QSize(static_cast<int>(mode->width),
+                                  static_cast<int>(mode->height));
+            modeInfo.refresh = ModeRefresh(mode);
+            modeInfo.pixelClock = mode->dotClock / 1000000.0;
+            modeInfo.current = mode->id == currentMode;
+            modeInfo.preferred = j < output->npreferred;
+            info.modes.append(modeInfo);
+        }
+
+        // Get EDID
+        if (edidAtom != None)
+        {
+            Atom type = None;
+            int format = 0;
+            unsigned long items = 0;
+            unsigned long bytesAfter = 0;
+            unsigned char *data = nullptr;
+            if (XRRGetOutputProperty(display, id, edidAtom, 0, 256, False, False,
+                                     AnyPropertyType, &type, &format, &items, &bytesAfter,
+                                     &data)
+                == Success)
+            {
+                if (type == XA_INTEGER && format == 8 && data)
+                    info.edid = QByteArray(reinterpret_cast<char *>(data),
+                                           static_cast<int>(items));
+                if (data)
+                    XFree(data);
+            }
+        }
+
+        inventory.outputs.append(info);
+        XRRFreeOutputInfo(output);
+    }
+
+    XRRFreeScreenResources(resources);
+    return true;
+#else
+    (void)inventory;
+    setErrorString("HiDPI Fixer was built without libXrandr");
+    return false;
+#endif
+}
+
+/**
+ * Registers the given @a modeline (if it does not exist yet) and adds it to
+ * the @a output
+ */
+bool XrandrNativeBackend::createMode(const QString &output, const QString &modeline)
+{
+#ifdef HAVE_XRANDR
+    if (!isValid())
+    {
+        setErrorString("Not connected to an X server");
+        return false;
+    }
+
+    // Parse modeline (name clock hdisp hsyncstart hsyncend htotal vdisp ...)
+    const QStringList tokens = modeline.split(' ', Qt::SkipEmptyParts);
+    if (tokens.count() < 10)
+    {
+        setErrorString(QString("Invalid modeline \"%1\"").arg(modeline));
+        return false;
+    }
+
+    // Create mode information
+    QByteArray name = tokens.at(0).toLatin1();
+    name.replace("\"", "");
+    XRRModeInfo mode;
+    memset(&mode, 0, sizeof(mode));
+    mode.dotClock = static_cast<unsigned long>(tokens.at(1).toDouble() * 1000000);
+    mode.width = tokens.at(2).toUInt();
+    mode.hSyncStart = tokens.at(3).toUInt();
+    mode.hSyncEnd = tokens.at(4).toUInt();
+    mode.hTotal = tokens.at(5).toUInt();
+    mode.height = tokens.at(6).toUInt();
+    mode.vSyncStart = tokens.at(7).toUInt();
+    mode.vSyncEnd = tokens.at(8).toUInt();
+    mode.vTotal = tokens.at(9).toUInt();
+    mode.name = name.data();
+    mode.nameLength = static_cast<unsigned int>(name.size());
+
+    // Get sync polarity flags
+    for (int i = 10; i < tokens.count(); ++i)
+    {
+        const QString flag = tokens.at(i).toLower();
+        if (flag == "+hsync")
+            mode.modeFlags |= RR_HSyncPositive;
+        else if (flag == "-hsync")
+            mode.modeFlags |= RR_HSyncNegative;
+        else if (flag == "+vsync")
+            mode.modeFlags |= RR_VSyncPositive;
+        else if (flag == "-vsync")
+            mode.modeFlags |= RR_VSyncNegative;
+        else if (flag == "interlace")
+            mode.modeFlags |= RR_Interlace;
+    }
+
+    LAST_X_ERROR = 0;
+    Display *display = static_cast<Display *>(m_display);
+    const Window root = DefaultRootWindow(display);
+    XRRScreenResources *resources = XRRGetScreenResourcesCurrent(display, root);
+    if (!resources)
+    {
+        setErrorString("Cannot get RandR screen resources");
+        return false;
+    }
+
+    // Get output
+    const RROutput outputId = FindOutput(display, resources, output);
+    if (outputId == None)
+    {
+        XRRFreeScreenResources(resources);
+        setErrorString(QString("Output %1 not found").arg(output));
+        return false;
+    }
+
+    // Create mode if it does not exist yet
+    const XRRModeInfo *existing = FindMode(resources, name);
+    const RRMode modeId = existing ? existing->id : XRRCreateMode(display, root, &mode);
+    XRRFreeScreenResources(resources);
+
+    // Register mode with the output
+    XRRAddOutputMode(display, outputId, modeId);
+    if (!SyncWithoutErrors(display))
+    {
+        setErrorString(QString("Cannot add mode %1 to %2 (X error %3)")
+                           .arg(QString::fromLatin1(name))
+                           .arg(output)
+                           .arg(LAST_X_ERROR));
+        return false;
+    }
+
+    return true;
+#else
+    (void)output;
+    (void)modeline;
+    setErrorString("HiDPI Fixer was built without libXrandr");
+    return false;
+#endif
+}
+
+/**
+ * Applies the given @a layout with a single server grab, configuring the
+ * screen size, CRTC transforms, modes, positions and panning areas
+ */
+bool XrandrNativeBackend::applyLayout(const DisplayLayout &layout, const bool xrandrScale)
+{
+#ifdef HAVE_XRANDR
+    if (!isValid())
+    {
+        setErrorString("Not connected to an X server");
+        return false;
+    }
+
+    LAST_X_ERROR = 0;
+    Display *display = static_cast<Display *>(m_display);
+    const Window root = DefaultRootWindow(display);
+    XRRScreenResources *resources = XRRGetScreenResourcesCurrent(display, root);
+    if (!resources)
+    {
+        setErrorString("Cannot get RandR screen resources");
+        return false;
+    }
+
+    // Output, CRTC, mode and position assigned to each display of the layout
+    struct Target
+    {
+        RROutput output;
+        RRCrtc crtc;
+        RRMode mode;
+        QPoint position;
+    };
+
+    // Find the output, CRTC and mode of each display
+    QString error;
+    QVector<Target> targets;
+    for (int i = 0; i < layout.displays.count() && error.isEmpty(); ++i)
+    {
+        const DisplayConfig &config = layout.displays.at(i);
+
+        // Get output
+        const RROutput id = FindOutput(display, resources, config.name);
+        Target target = { id, None, None, config.position };
+        if (target.output == None)
+        {
+            error = QString("Output %1 not found").arg(config.name);
+            break;
+        }
+
+        XRROutputInfo *output = XRRGetOutputInfo(display, resources, target.output);
+        if (!output)
+        {
+            error = QString("Cannot get information of %1").arg(config.name);
+            break;
+        }
+
+        // Get mode, custom modes are found by name, otherwise use the first
+        // (preferred) mode with the selected size and refresh rate
+        const QByteArray modeName = LayoutGetModeName(config).toLatin1();
+        for (int j = 0; j < output->nmode && target.mode == None; ++j)
+        {
+            const XRRModeInfo *mode = FindMode(resources, output->modes[j]);
+            if (!mode)
+                continue;
+
+            if (!xrandrScale)
+            {
+                if (QByteArray(mode->name, mode->nameLength) == modeName)
+                    target.mode = mode->id;
+            }
+
+            else if (static_cast<int>(mode->width) == config.mode.width()
+                     && static_cast<int>(mode->height) == config.mode.height()
+                     && (config.refresh <= 0
+                         || qAbs(ModeRefresh(mode) - config.refresh) < 0.5))
+                target.mode = mode->id;
+        }
+
+        // Displays of an incomplete layout keep their current position, the
+        // displays that are off are placed at the right of the screen
+        if (!layout.complete)
+        {
+            target.position = QPoint(DisplayWidth(display, DefaultScreen(display)), 0);
+            XRRCrtcInfo *crtc = output->crtc
+                ? XRRGetCrtcInfo(display, resources, output->crtc)
+                : nullptr;
+            if (crtc)
+            {
+                if (crtc->mode != None)
+                    target.position = QPoint(crtc->x, crtc->y);
+
+                XRRFreeCrtcInfo(crtc);
+            }
+        }
+
+        // Use current CRTC, or the first one that is not used by other outputs
+        target.crtc = output->crtc;
+        for (int j = 0; j < output->ncrtc && target.crtc == None; ++j)
+        {
+            bool used = false;
+            for (int k = 0; k < targets.count(); ++k)
+                used |= targets.at(k).crtc == output->crtcs[j];
+
+            // Treat CRTCs that cannot be queried as used
+            XRRCrtcInfo *crtc = XRRGetCrtcInfo(display, resources, output->crtcs[j]);
+            used |= !crtc || crtc->noutput > 0;
+            if (crtc)
+                XRRFreeCrtcInfo(crtc);
+
+            if (!used)
+                target.crtc = output->crtcs[j];
+        }
+
+        XRRFreeOutputInfo(output);
+
+        // Validate target
+        if (target.mode == None)
+            error = QString("No suitable mode found for %1").arg(config.name);
+        else if (target.crtc == None)
+            error = QString("No CRTC available for %1").arg(config.name);
+        else
+            targets.append(target);
+    }
+
+    // Abort if some display cannot be configured
+    if (!error.isEmpty())
+    {
+        XRRFreeScreenResources(resources);
+        setErrorString(error);
+        return false;
+    }
+
+    // The framebuffer contains every display of the layout
+    int fbWidth = layout.complete ? layout.framebuffer.width() : 0;
+    int fbHeight = layout.complete ? layout.framebuffer.height() : 0;
+    for (int i = 0; i < targets.count(); ++i)
+    {
+        const QSize size = layout.displays.at(i).virtualSize;
+        fbWidth = qMax(fbWidth, targets.at(i).position.x() + size.width());
+        fbHeight = qMax(fbHeight, targets.at(i).position.y() + size.height());
+    }
+
+    // ...and the CRTCs that are not part of the layout, which are never
+    // changed
+    QVector<XRRCrtcInfo *> crtcs(resources->ncrtc, nullptr);
+    for (int i = 0; i < resources->ncrtc; ++i)
+    {
+        bool used = false;
+        for (int j = 0; j < targets.count(); ++j)
+            used |= targets.at(j).crtc == resources->crtcs[i];
+
+        crtcs[i] = XRRGetCrtcInfo(display, resources, resources->crtcs[i]);
+        const XRRCrtcInfo *crtc = crtcs.at(i);
+        if (!used && crtc && crtc->mode != None)
+        {
+            fbWidth = qMax(fbWidth, crtc->x + static_cast<int>(crtc->width));
+            fbHeight = qMax(fbHeight, crtc->y + static_cast<int>(crtc->height));
+        }
+    }
+
+    // Respect the minimum screen size
+    int minWidth = 0;
+    int minHeight = 0;
+    int maxWidth = 0;
+    int maxHeight = 0;
+    XRRGetScreenSizeRange(display, root, &minWidth, &minHeight, &maxWidth, &maxHeight);
+    fbWidth = qMax(fbWidth, minWidth);
+    fbHeight = qMax(fbHeight, minHeight);
+
+    // Apply all changes at once
+    XGrabServer(display);
+
+    // Disable the CRTCs of the layout that do not fit in the new framebuffer
+    // (they are configured again below)
+    for (int i = 0; i < resources->ncrtc; ++i)
+    {
+        bool used = false;
+        for (int j = 0; j < targets.count(); ++j)
+            used |= targets.at(j).crtc == resources->crtcs[i];
+
+        const XRRCrtcInfo *crtc = crtcs.at(i);
+        if (used && crtc && crtc->mode != None
+            && (crtc->x + static_cast<int>(crtc->width) > fbWidth
+                || crtc->y + static_cast<int>(crtc->height) > fbHeight))
+        {
+            XRRSetCrtcConfig(display, resources, resources->crtcs[i], CurrentTime, 0, 0,
+                             None, RR_Rotate_0, nullptr, 0);
+        }
+    }
+
+    // Free CRTC information
+    for (int i = 0; i < crtcs.count(); ++i)
+    {
+        if (crtcs.at(i))
+            XRRFreeCrtcInfo(crtcs.at(i));
+    }
+
+    // Resize the screen (the physical size keeps a 96 DPI ratio)
+    XRRSetScreenSize(display, root, fbWidth, fbHeight,
+                     static_cast<int>(fbWidth * 25.4 / 96),
+                     static_cast<int>(fbHeight * 25.4 / 96));
+
+    // Configure each CRTC
+    for (int i = 0; i < targets.count(); ++i)
+    {
+        const DisplayConfig &config = layout.displays.at(i);
+        Target &target = targets[i];
+
+        // Set scaling transform (applied with the next CRTC configuration),
+        // the mode is scaled to fill exactly the virtual size of the display
+        // (in the orientation of the mode, the rotation is applied after it)
+        double xFactor = 1.0;
+        double yFactor = 1.0;
+        if (xrandrScale)
+        {
+            const QSize size = LayoutGetScaleFrom(config);
+            xFactor = static_cast<double>(size.width()) / config.mode.width();
+            yFactor = static_cast<double>(size.height()) / config.mode.height();
+        }
+
+        XTransform transform;
+        memset(&transform, 0, sizeof(transform));
+        transform.matrix[0][0] = XDoubleToFixed(xFactor);
+        transform.matrix[1][1] = XDoubleToFixed(yFactor);
+        transform.matrix[2][2] = XDoubleToFixed(1.0);
+        char filter[] = "bilinear";
+        char nearest[] = "nearest";
+        const bool scaled = xFactor != 1.0 || yFactor != 1.0;
+
+        // Only change the transform if needed, like xrandr (some servers,
+        // such as Xvfb, do not support transforms at all)
+        XRRCrtcTransformAttributes *attributes = nullptr;
+        bool changed = true;
+        if (XRRGetCrtcTransform(display, target.crtc, &attributes) && attributes)
+        {
+            changed = memcmp(&attributes->currentTransform, &transform,
+                             sizeof(transform))
+                      != 0;
+            XFree(attributes);
+        }
+        if (changed)
+            XRRSetCrtcTransform(display, target.crtc, &transform,
+                                scaled ? filter : nearest, nullptr, 0);
+
+        // Set mode, position and rotation
+        XRRSetCrtcConfig(display, resources, target.crtc, CurrentTime,
+                         target.position.x(), target.position.y(), target.mode,
+                         RotationValue(config.rotation), &target.output, 1);
+
+        // Set panning area (or disable the one left by the --scale method),
+        // it is only changed if needed, because some servers (such as Xvfb)
+        // do not support panning
+        QRect area;
+        if (xrandrScale && scaled)
+            area = QRect(target.position, config.virtualSize);
+
+        XRRPanning *panning = XRRGetPanning(display, resources, target.crtc);
+        if (panning
+            && (static_cast<int>(panning->left) != qMax(area.x(), 0)
+                || static_cast<int>(panning->top) != qMax(area.y(), 0)
+                || static_cast<int>(panning->width) != area.width()
+                || static_cast<int>(panning->height) != area.height()))
+        {
+            panning->left = static_cast<unsigned int>(qMax(area.x(), 0));
+            panning->top = static_cast<unsigned int>(qMax(area.y(), 0));
+            panning->width = static_cast<unsigned int>(area.width());
+            panning->height = static_cast<unsigned int>(area.height());
+            panning->track_left = 0;
+            panning->track_top = 0;
+            panning->track_width = 0;
+            panning->track_height = 0;
+            panning->border_left = 0;
+            panning->border_top = 0;
+            panning->border_right = 0;
+            panning->border_bottom = 0;
+            XRRSetPanning(display, resources, target.crtc, panning);
+        }
+        if (panning)
+            XRRFreePanning(panning);
+    }
+
+    XUngrabServer(display);
+    XRRFreeScreenResources(resources);
+
+    // Check for errors
+    if (!SyncWithoutErrors(display))
+    {
+        setErrorString(
+            QString("Cannot apply display layout (X error %1)").arg(LAST_X_ERROR));
+        return false;
+    }
+
+    return true;
+#else
+    (void)layout;
+    (void)xrandrScale;
+    setErrorString("HiDPI Fixer was built without libXrandr");
+    return false;
+#endif
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QProcess>
+
+#include "XRandrBridge.h"
+#include "XrandrProcessBackend.h"
+
+/**
+ * Creates a backend that runs xrandr on the given X @a display
+ */
+XrandrProcessBackend::XrandrProcessBackend(const QString &display)
+    : m_display(display)
+{
+}
+
+/**
+ * Returns the name of the backend
+ */
+QString XrandrProcessBackend::name() const
+{
+    return "xrandr";
+}
+
+/**
+ * Reads the screen limits, outputs and modes from xrandr --verbose
+ */
+bool XrandrProcessBackend::inventory(ScreenInventory &inventory)
+{
+    const XrandrResult result = XrandrGetVerboseOutput(m_display);
+    if (result.error != XrandrNoError)
+    {
+        setErrorString(XrandrErrorString(result));
+        return false;
+    }
+
+    inventory = InventoryParseXrandrVerbose(result.output);
+    return true;
+}
+
+/**
+ * Registers the given @a modeline and adds it to the @a output
+ */
+bool XrandrProcessBackend::createMode(const QString &output, const QString &modeline)
+{
+    // Split modeline into arguments (removing the quotes of the mode name)
+    QStringList arguments = modeline.split(' ', Qt::SkipEmptyParts);
+    if (arguments.isEmpty())
+    {
+        setErrorString(QString("Invalid modeline \"%1\"").arg(modeline));
+        return false;
+    }
+    arguments[0].remove('"');
+    const QString name = arguments.first();
+
+    // Create new resolution, this fails if the mode already exists, which is
+    // fine as long as it can be added to the output
+    XrandrExecute(QStringList { "--newmode" } + arguments, m_display);
+
+    // Register resolution with the output
+    const XrandrResult result
+        = XrandrExecute(QStringList { "--addmode", output, name }, m_display);
+    if (result.error != XrandrNoError)
+    {
+        setErrorString(XrandrErrorString(result));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Applies the given @a layout with a single xrandr call
+ */
+bool XrandrProcessBackend::applyLayout(const DisplayLayout &layout,
+                                       const bool xrandrScale)
+{
+    const XrandrResult result
+        = XrandrExecute(LayoutGetXrandrArguments(layout, xrandrScale), m_display);
+    if (result.error != XrandrNoError)
+    {
+        setErrorString(XrandrErrorString(result));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Merges the given X @a resources into the RESOURCE_MANAGER property with
+ * xrdb, the resources with empty values are removed
+ */
+bool XrandrProcessBackend::setResources(const QMap<QString, QString> &resources)
+{
+    QByteArray merge;
+    QByteArray remove;
+    for (auto it = resources.constBegin(); it != resources.constEnd(); ++it)
+    {
+        if (it.value().isEmpty())
+            remove.append(QString("%1:\n").arg(it.key()).toUtf8());
+        else
+            merge.append(QString("%1: %2\n").arg(it.key()).arg(it.value()).toUtf8());
+    }
+
+    return (merge.isEmpty() || runXrdb("-merge", merge))
+           && (remove.isEmpty() || runXrdb("-remove", remove));
+}
+
+/**
+ * Runs xrdb with the given @a option on the X display, @a input is written
+ * to its standard input
+ */
+bool XrandrProcessBackend::runXrdb(const QString &option, const QByteArray &input)
+{
+    QStringList arguments;
+    arguments << "-nocpp" << option;
+    if (!m_display.isEmpty())
+        arguments << "-display" << m_display;
+
+    QProcess process;
+    process.start("xrdb", arguments);
+    process.write(input);
+    process.closeWriteChannel();
+    if (!process.waitForFinished(10000) || process.exitStatus() != QProcess::NormalExit
+        || process.exitCode() != 0)
+    {
+        const QString error = QString::fromUtf8(process.readAllStandardError());
+        setErrorString(QString("Cannot set X resources: %1").arg(error.trimmed()));
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef XRANDR_PROCESS_BACKEND_H
+#define XRANDR_PROCESS_BACKEND_H
+
+#include "DisplayBackend.h"
+
+/**
+ * Display backend that runs the xrandr utility
+ */
+class XrandrProcessBackend : public DisplayBackend
+{
+public:
+    explicit XrandrProcessBackend(const QString &display);
+
+    QString name() const override;
+    bool inventory(ScreenInventory &inventory) override;
+    bool createMode(const QString &output, const QString &modeline) override;
+    bool applyLayout(const DisplayLayout &layout, const bool xrandrScale) override;
+    bool setResources(const QMap<QString, QString> &resources) override;
+
+private:
+    bool runXrdb(const QString &option, const QByteArray &input);
+
+private:
+    QString m_display;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#
+# Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+
+#-------------------------------------------------------------------------------
+# Project configuration
+#-------------------------------------------------------------------------------
+
+TEMPLATE = lib
+TARGET = hidpi-fixer-core
+CONFIG += staticlib
+
+#-------------------------------------------------------------------------------
+# Import Qt modules
+#-------------------------------------------------------------------------------
+
+QT = core
+
+#-------------------------------------------------------------------------------
+# Native RandR backend (optional)
+#-------------------------------------------------------------------------------
+
+linux:!android {
+    CONFIG += link_pkgconfig
+    packagesExist(x11 xrandr) {
+        PKGCONFIG += x11 xrandr
+        DEFINES += HAVE_XRANDR
+    }
+}
+
+#-------------------------------------------------------------------------------
+# Make options
+#-------------------------------------------------------------------------------
+
+MOC_DIR = moc
+OBJECTS_DIR = obj
+
+CONFIG += c++17
+
+#-------------------------------------------------------------------------------
+# Import source code
+#-------------------------------------------------------------------------------
+
+SOURCES += \
+    $$PWD/Cvt.cpp \
+    $$PWD/DesktopIndex.cpp \
+    $$PWD/DisplayBackend.cpp \
+    $$PWD/DisplayInventory.cpp \
+    $$PWD/DisplayLayout.cpp \
+    $$PWD/DisplaySnapshot.cpp \
+    $$PWD/Edid.cpp \
+    $$PWD/FleetBatch.cpp \
+    $$PWD/MultiSession.cpp \
+    $$PWD/PowerSupply.cpp \
+    $$PWD/Preflight.cpp \
+    $$PWD/ProfileStore.cpp \
+    $$PWD/ReplayBackend.cpp \
+    $$PWD/ScriptFile.cpp \
+    $$PWD/SessionHook.cpp \
+    $$PWD/StartupVerifications.cpp \
+    $$PWD/XRandrBridge.cpp \
+    $$PWD/XrandrNativeBackend.cpp \
+    $$PWD/XrandrProcessBackend.cpp
+
+HEADERS += \
+    $$PWD/Cvt.h \
+    $$PWD/DesktopIndex.h \
+    $$PWD/DisplayBackend.h \
+    $$PWD/DisplayInventory.h \
+    $$PWD/DisplayLayout.h \
+    $$PWD/DisplaySnapshot.h \
+    $$PWD/Edid.h \
+    $$PWD/FleetBatch.h \
+    $$PWD/Global.h \
+    $$PWD/MultiSession.h \
+    $$PWD/PowerSupply.h \
+    $$PWD/Preflight.h \
+    $$PWD/ProfileStore.h \
+    $$PWD/ReplayBackend.h \
+    $$PWD/ScriptFile.h \
+    $$PWD/SessionHook.h \
+    $$PWD/StartupVerifications.h \
+    $$PWD/XRandrBridge.h \
+    $$PWD/XrandrNativeBackend.h \
+    $$PWD/XrandrProcessBackend.h
+
+OTHER_FILES += \
+    $$PWD/core.pri
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TEST_EDID_H
+#define TEST_EDID_H
+
+#include <QByteArray>
+
+/**
+ * Display range limits written by TestMakeEdid() (rates in Hz/kHz, clock in
+ * MHz), @a flags holds the EDID 1.4 rate offset flags
+ */
+struct TestRangeLimits
+{
+    int flags = 0;
+    int minVRate = 48;
+    int maxVRate = 75;
+    int minHRate = 30;
+    int maxHRate = 160;
+    int maxPixelClock = 600;
+};
+
+/**
+ * Returns an EDID 1.4 base block (with a valid checksum) that reports the
+ * monitor @a name, the physical size in cm and, if @a hasLimits is set, the
+ * given display range @a limits
+ */
+inline QByteArray TestMakeEdid(const QByteArray &name, const int widthCm = 60,
+                               const int heightCm = 34,
+                               const TestRangeLimits &limits = TestRangeLimits(),
+                               const bool hasLimits = true)
+{
+    QByteArray edid(128, '\0');
+    edid.replace(0, 8, QByteArray::fromHex("00ffffffffffff00"));
+    edid[18] = 1;
+    edid[19] = 4;
+    edid[21] = static_cast<char>(widthCm);
+    edid[22] = static_cast<char>(heightCm);
+
+    // Display range limits descriptor (in place of the preferred timings)
+    if (hasLimits)
+    {
+        edid[57] = static_cast<char>(0xfd);
+        edid[58] = static_cast<char>(limits.flags);
+        edid[59] = static_cast<char>(limits.minVRate);
+        edid[60] = static_cast<char>(limits.maxVRate);
+        edid[61] = static_cast<char>(limits.minHRate);
+        edid[62] = static_cast<char>(limits.maxHRate);
+        edid[63] = static_cast<char>(limits.maxPixelClock / 10);
+    }
+
+    // Display product name descriptor (terminated with a linefeed)
+    QByteArray text = name.left(12) + '\n';
+    text.append(QByteArray(13 - text.size(), ' '));
+    edid[75] = static_cast<char>(0xfc);
+    edid.replace(77, 13, text);
+
+    // Make the sum of the block 0
+    quint8 sum = 0;
+    for (int i = 0; i < 127; ++i)
+        sum += static_cast<quint8>(edid.at(i));
+    edid[127] = static_cast<char>(0x100 - sum);
+    return edid;
+}
+
+#endif
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtTest>
+
+#include "Cvt.h"
+#include "DisplayLayout.h"
+
+/**
+ * Checks the CVT port and the layout engine against modelines generated by
+ * the cvt utility (cvt <width> <height>)
+ */
+class TestCvt : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void modeline_data();
+    void modeline();
+    void layoutWidths();
+    void nativeLayout();
+    void rotatedLayout();
+};
+
+void TestCvt::modeline_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("1280x800") << 1280 << 800
+                              << "\"1280x800_60.00\"   83.50  1280 1352 1480 1680  "
+                                 "800 803 809 831 -hsync +vsync";
+    QTest::newRow("1366x768") << 1366 << 768
+                              << "\"1368x768_60.00\"   85.25  1368 1440 1576 1784  "
+                                 "768 771 781 798 -hsync +vsync";
+    QTest::newRow("1920x1080") << 1920 << 1080
+                               << "\"1920x1080_60.00\"  173.00  1920 2048 2248 2576  "
+                                  "1080 1083 1088 1120 -hsync +vsync";
+    QTest::newRow("2560x1440") << 2560 << 1440
+                               << "\"2560x1440_60.00\"  312.25  2560 2752 3024 3488  "
+                                  "1440 1443 1448 1493 -hsync +vsync";
+    QTest::newRow("2733x1537") << 2733 << 1537
+                               << "\"2736x1537_60.00\"  356.00  2736 2936 3232 3728  "
+                                  "1537 1540 1550 1593 -hsync +vsync";
+    QTest::newRow("3840x2160") << 3840 << 2160
+                               << "\"3840x2160_60.00\"  712.75  3840 4160 4576 5312  "
+                                  "2160 2163 2168 2237 -hsync +vsync";
+}
+
+void TestCvt::modeline()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(QString, expected);
+
+    QCOMPARE(CvtGetModeline(width, height, 60), expected);
+}
+
+/**
+ * The virtual widths must be the widths of the custom modes, so that the
+ * displays are placed next to each other without overlapping
+ */
+void TestCvt::layoutWidths()
+{
+    DisplayConfig internal;
+    internal.name = "eDP-1";
+    internal.mode = QSize(1366, 768);
+    internal.scale = 1;
+
+    DisplayConfig external;
+    external.name = "HDMI-1";
+    external.mode = QSize(1920, 1080);
+    external.scale = 1.5;
+
+    const DisplayLayout layout = LayoutCompute({internal, external}, QSize());
+    QCOMPARE(layout.factor, 2);
+    QCOMPARE(layout.displays.count(), 2);
+
+    int x = 0;
+    for (const DisplayConfig &display : layout.displays)
+    {
+        const QString name = CvtGetResolutionName(LayoutGetModeline(display));
+        QCOMPARE(display.virtualSize.width() % 8, 0);
+        QVERIFY(name.startsWith(QString("\"%1x").arg(display.virtualSize.width())));
+        QCOMPARE(display.position, QPoint(x, 0));
+        x += display.virtualSize.width();
+    }
+
+    QCOMPARE(layout.framebuffer.width(), x);
+}
+
+/**
+ * The native layout (used to undo the scaling) keeps the exact mode of each
+ * display, without rounding
+ */
+void TestCvt::nativeLayout()
+{
+    DisplayConfig internal;
+    internal.name = "eDP-1";
+    internal.mode = QSize(1366, 768);
+    internal.scale = 1.5;
+
+    DisplayConfig external;
+    external.name = "HDMI-1";
+    external.mode = QSize(1920, 1080);
+    external.scale = 1;
+
+    const DisplayLayout scaled = LayoutCompute({internal, external}, QSize());
+    const DisplayLayout layout = LayoutNative(scaled);
+    QCOMPARE(layout.factor, 1);
+    QCOMPARE(layout.displays.at(0).virtualSize, QSize(1366, 768));
+    QCOMPARE(layout.displays.at(1).virtualSize, QSize(1920, 1080));
+
+    const QRect first(layout.displays.at(0).position, layout.displays.at(0).virtualSize);
+    const QRect second(layout.displays.at(1).position, layout.displays.at(1).virtualSize);
+    QVERIFY(!first.intersects(second));
+    QCOMPARE(layout.framebuffer, first.united(second).size());
+}
+
+/**
+ * Displays rotated to the left or right take the transposed size in the
+ * framebuffer, while their custom modes keep the orientation of the mode
+ */
+void TestCvt::rotatedLayout()
+{
+    DisplayConfig portrait;
+    portrait.name = "eDP-1";
+    portrait.mode = QSize(1366, 768);
+    portrait.rotation = "left";
+    portrait.scale = 1;
+
+    DisplayConfig external;
+    external.name = "HDMI-1";
+    external.mode = QSize(1920, 1080);
+    external.scale = 2;
+
+    const DisplayLayout layout = LayoutCompute({portrait, external}, QSize());
+    const DisplayConfig &display = layout.displays.at(0);
+    QCOMPARE(display.virtualSize, QSize(1536, 2736));
+    QCOMPARE(LayoutGetScaleFrom(display), QSize(2736, 1536));
+    QVERIFY(CvtGetResolutionName(LayoutGetModeline(display)).startsWith("\"2736x1536"));
+    QVERIFY(LayoutGetXrandrArguments(layout, true).contains("left"));
+
+    const DisplayLayout native = LayoutNative(layout);
+    QCOMPARE(native.displays.at(0).virtualSize, QSize(768, 1366));
+}
+
+QTEST_APPLESS_MAIN(TestCvt)
+
+#include "tst_Cvt.moc"
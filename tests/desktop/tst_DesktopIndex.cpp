@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QtTest>
+
+#include "Global.h"
+#include "DesktopIndex.h"
+
+/**
+ * Writes a .desktop file with the given @a contents at @a path (relative to
+ * @a dir), creating its subdirectories if needed
+ */
+static void WriteEntry(const QString &dir, const QString &path, const QString &contents)
+{
+    const QFileInfo info(QDir(dir).filePath(path));
+    QVERIFY(QDir().mkpath(info.absolutePath()));
+
+    QFile file(info.absoluteFilePath());
+    QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+    file.write(contents.toUtf8());
+    file.close();
+}
+
+/**
+ * Returns the contents of an application entry called @a name
+ */
+static QString Application(const QString &name, const QString &extra = QString())
+{
+    return QString("[Desktop Entry]\n"
+                   "Type=Application\n"
+                   "Name=%1\n"
+                   "Exec=%2 %U\n"
+                   "Icon=%2\n"
+                   "%3")
+        .arg(name)
+        .arg(name.toLower())
+        .arg(extra);
+}
+
+/**
+ * Returns the names of the given @a entries
+ */
+static QStringList Names(const QList<DesktopEntry> &entries)
+{
+    QStringList names;
+    for (int i = 0; i < entries.count(); ++i)
+        names.append(entries.at(i).name);
+
+    return names;
+}
+
+/**
+ * Checks the .desktop parser and the incremental index of the applications
+ * against fake application directories
+ */
+class TestDesktopIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void parse();
+    void hiddenEntries();
+    void applications();
+    void incrementalUpdate();
+    void cache();
+
+private:
+    QStringList dirs() const;
+
+    QScopedPointer<QTemporaryDir> m_dir;
+};
+
+/**
+ * Creates a user directory (with a launcher and an override of a system
+ * entry) and a system directory with a vendor subdirectory
+ */
+void TestDesktopIndex::init()
+{
+    m_dir.reset(new QTemporaryDir());
+    QVERIFY(m_dir->isValid());
+
+    const QString user = m_dir->filePath("user");
+    WriteEntry(user, "firefox.desktop",
+               Application("Firefox", QString("%1=true\n").arg(LAUNCHER_MARKER)));
+    WriteEntry(user, "gimp.desktop", Application("GIMP (custom)"));
+
+    const QString system = m_dir->filePath("system");
+    WriteEntry(system, "firefox.desktop", Application("Firefox"));
+    WriteEntry(system, "gimp.desktop", Application("GIMP"));
+    WriteEntry(system, "kde/dolphin.desktop", Application("dolphin"));
+    WriteEntry(system, "settings.desktop", Application("Settings", "NoDisplay=true\n"));
+}
+
+/**
+ * Returns the application directories sorted by priority
+ */
+QStringList TestDesktopIndex::dirs() const
+{
+    return QStringList({m_dir->filePath("user"), m_dir->filePath("system")});
+}
+
+/**
+ * Only the keys of the main group are read, ignoring localized keys and
+ * actions
+ */
+void TestDesktopIndex::parse()
+{
+    WriteEntry(m_dir->path(), "editor.desktop",
+               "# Comment\n"
+               "[Desktop Entry]\n"
+               "Type=Application\n"
+               "Name = Editor\n"
+               "Name[de]=Bearbeiter\n"
+               "Exec=editor --new %F\n"
+               "Icon=accessories-text-editor\n"
+               "Actions=window;\n"
+               "\n"
+               "[Desktop Action window]\n"
+               "Name=New Window\n"
+               "Exec=editor --window\n");
+
+    DesktopEntry entry;
+    QVERIFY(DesktopParse(m_dir->filePath("editor.desktop"), entry));
+    QCOMPARE(entry.name, QString("Editor"));
+    QCOMPARE(entry.exec, QString("editor --new %F"));
+    QCOMPARE(entry.icon, QString("accessories-text-editor"));
+    QVERIFY(entry.visible);
+    QVERIFY(!entry.launcher);
+
+    DesktopEntry launcher;
+    QVERIFY(DesktopParse(m_dir->filePath("user/firefox.desktop"), launcher));
+    QVERIFY(launcher.launcher);
+
+    DesktopEntry missing;
+    QVERIFY(!DesktopParse(m_dir->filePath("missing.desktop"), missing));
+}
+
+/**
+ * Entries hidden from the menus, links and entries without a command are
+ * not shown
+ */
+void TestDesktopIndex::hiddenEntries()
+{
+    const QStringList contents = {
+        Application("Settings", "NoDisplay=true\n"),
+        Application("Removed", "Hidden=true\n"),
+        "[Desktop Entry]\nType=Link\nName=Website\nURL=https://example.com\n",
+        "[Desktop Entry]\nType=Application\nName=Broken\n",
+        "[Desktop Entry]\nType=Application\nExec=unnamed\n",
+    };
+
+    for (int i = 0; i < contents.count(); ++i)
+    {
+        const QString path = m_dir->filePath(QString("hidden-%1.desktop").arg(i));
+        WriteEntry(m_dir->path(), QFileInfo(path).fileName(), contents.at(i));
+
+        DesktopEntry entry;
+        QVERIFY(DesktopParse(path, entry));
+        QVERIFY2(!entry.visible, qPrintable(contents.at(i)));
+    }
+}
+
+/**
+ * Files of the user directory replace the system ones with the same ID,
+ * except launchers, and IDs include the subdirectories
+ */
+void TestDesktopIndex::applications()
+{
+    DesktopIndex index(m_dir->filePath("index.json"));
+    QCOMPARE(index.update(dirs()), 6);
+
+    const QList<DesktopEntry> applications = index.applications();
+    QCOMPARE(Names(applications), QStringList({"dolphin", "Firefox", "GIMP (custom)"}));
+    QCOMPARE(applications.at(0).id, QString("kde-dolphin.desktop"));
+    QCOMPARE(applications.at(1).path, m_dir->filePath("system/firefox.desktop"));
+    QCOMPARE(applications.at(2).path, m_dir->filePath("user/gimp.desktop"));
+    QCOMPARE(index.launchers(), QSet<QString>({"firefox.desktop"}));
+}
+
+/**
+ * Only new and modified files are parsed again, deleted files are dropped
+ */
+void TestDesktopIndex::incrementalUpdate()
+{
+    DesktopIndex index(m_dir->filePath("index.json"));
+    QCOMPARE(index.update(dirs()), 6);
+    QCOMPARE(index.update(dirs()), 0);
+
+    // Modified file
+    const QString path = m_dir->filePath("system/kde/dolphin.desktop");
+    WriteEntry(m_dir->filePath("system"), "kde/dolphin.desktop", Application("Dolphin"));
+    QFile file(path);
+    QVERIFY(file.open(QFile::ReadWrite));
+    QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(60),
+                             QFile::FileModificationTime));
+    file.close();
+    QCOMPARE(index.update(dirs()), 1);
+    QCOMPARE(index.applications().at(0).name, QString("Dolphin"));
+
+    // New file
+    WriteEntry(m_dir->filePath("user"), "editor.desktop", Application("Editor"));
+    QCOMPARE(index.update(dirs()), 1);
+    QCOMPARE(index.applications().count(), 4);
+
+    // Deleted files (the system entry is shown again)
+    QVERIFY(QFile::remove(path));
+    QVERIFY(QFile::remove(m_dir->filePath("user/gimp.desktop")));
+    QCOMPARE(index.update(dirs()), 0);
+    QCOMPARE(Names(index.applications()), QStringList({"Editor", "Firefox", "GIMP"}));
+}
+
+/**
+ * The index is saved to its cache and reused by the next instance
+ */
+void TestDesktopIndex::cache()
+{
+    const QString path = m_dir->filePath("cache/index.json");
+
+    DesktopIndex index(path);
+    QVERIFY(index.load());
+    QCOMPARE(index.update(dirs()), 6);
+    QVERIFY(index.save());
+
+    DesktopIndex cached(path);
+    QVERIFY(cached.load());
+    QCOMPARE(cached.update(dirs()), 0);
+    QCOMPARE(Names(cached.applications()), Names(index.applications()));
+    QCOMPARE(cached.launchers(), index.launchers());
+}
+
+QTEST_APPLESS_MAIN(TestDesktopIndex)
+
+#include "tst_DesktopIndex.moc"
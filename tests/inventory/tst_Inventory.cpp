@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QtTest>
+
+#include "TestEdid.h"
+#include "ProfileStore.h"
+#include "DisplayInventory.h"
+
+/**
+ * Returns the EDID property printed by xrandr --verbose for @a edid (16
+ * bytes per line, indented with two tabs)
+ */
+static QString EdidProperty(const QByteArray &edid)
+{
+    QString property = "\tEDID: \n";
+    const QString hex = QString::fromLatin1(edid.toHex());
+    for (int i = 0; i < hex.length(); i += 32)
+        property.append(QString("\t\t%1\n").arg(hex.mid(i, 32)));
+
+    return property;
+}
+
+/**
+ * Returns the output of xrandr --verbose recorded on a laptop scaled with
+ * --scale 1.5x1.5 (eDP-1), with a monitor rotated to the left at its right
+ * (HDMI-1) and an empty DisplayPort (DP-1)
+ */
+static QString RecordedOutput()
+{
+    return QString(
+               "Screen 0: minimum 320 x 200, current 3960 x 1920, maximum 16384 x "
+               "16384\n"
+               "eDP-1 connected primary 2880x1620+0+0 (0x48) normal (normal left "
+               "inverted right x axis y axis) 344mm x 194mm\n"
+               "\tIdentifier: 0x42 \n"
+               "\tTimestamp:  21396 \n"
+               "\tSubpixel:   unknown\n"
+               "\tGamma:      1.0:1.0:1.0\n"
+               "\tBrightness: 1.0\n"
+               "\tClones:    \n"
+               "\tCRTC:       0\n"
+               "\tCRTCs:      0 1 2\n"
+               "\tTransform:  1.500000 0.000000 0.000000\n"
+               "\t            0.000000 1.500000 0.000000\n"
+               "\t            0.000000 0.000000 1.000000\n"
+               "\t           filter: bilinear\n"
+               "%1"
+               "\tPanning:    2880x1620+0+0\n"
+               "\tTracking:   2880x1620+0+0\n"
+               "\tBorder:     0/0/0/0\n"
+               "  1920x1080 (0x48) 138.500MHz +HSync -VSync *current +preferred\n"
+               "        h: width  1920 start 1968 end 2000 total 2080 skew    0 "
+               "clock  66.59KHz\n"
+               "        v: height 1080 start 1083 end 1088 total 1111           "
+               "clock  59.93Hz\n"
+               "  1920x1080 (0x49) 110.880MHz +HSync -VSync\n"
+               "        h: width  1920 start 1968 end 2000 total 2080 skew    0 "
+               "clock  53.31KHz\n"
+               "        v: height 1080 start 1083 end 1088 total 1111           "
+               "clock  47.98Hz\n"
+               "  1280x720 (0x4a) 74.500MHz -HSync +VSync\n"
+               "        h: width  1280 start 1344 end 1472 total 1664 skew    0 "
+               "clock  44.77KHz\n"
+               "        v: height  720 start  723 end  728 total  748           "
+               "clock  59.86Hz\n"
+               "HDMI-1 connected 1080x1920+2880+0 (0x4b) left (normal left inverted "
+               "right x axis y axis) 0mm x 0mm\n"
+               "\tCRTC:       1\n"
+               "\tCRTCs:      1 2\n"
+               "\tTransform:  1.000000 0.000000 0.000000\n"
+               "\t            0.000000 1.000000 0.000000\n"
+               "\t            0.000000 0.000000 1.000000\n"
+               "\t           filter: \n"
+               "%2"
+               "\tPanning:    0x0+0+0\n"
+               "  1920x1080 (0x4b) 148.500MHz +HSync +VSync *current +preferred\n"
+               "        h: width  1920 start 2008 end 2052 total 2200 skew    0 "
+               "clock  67.50KHz\n"
+               "        v: height 1080 start 1084 end 1089 total 1125           "
+               "clock  60.00Hz\n"
+               "DP-1 disconnected (normal left inverted right x axis y axis)\n"
+               "\tCRTCs:      0 1 2\n"
+               "\tTransform:  1.000000 0.000000 0.000000\n"
+               "\t            0.000000 1.000000 0.000000\n"
+               "\t            0.000000 0.000000 1.000000\n"
+               "\t           filter: \n")
+        .arg(EdidProperty(TestMakeEdid("Internal", 34, 19)))
+        .arg(EdidProperty(TestMakeEdid("External")));
+}
+
+/**
+ * Checks the parser of xrandr --verbose, the JSON inventories and the
+ * fingerprints that identify each set of connected displays
+ */
+class TestInventory : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void screenLimits();
+    void outputs();
+    void modes();
+    void trailingEdid();
+    void jsonRoundTrip();
+    void fingerprint();
+    void fingerprintChanges();
+    void describe();
+};
+
+/**
+ * The screen limits are read from the first line
+ */
+void TestInventory::screenLimits()
+{
+    const ScreenInventory inventory = InventoryParseXrandrVerbose(RecordedOutput());
+    QCOMPARE(inventory.minimum, QSize(320, 200));
+    QCOMPARE(inventory.current, QSize(3960, 1920));
+    QCOMPARE(inventory.maximum, QSize(16384, 16384));
+}
+
+/**
+ * Each output is registered with its state, geometry, rotation, transform,
+ * panning, CRTCs and EDID
+ */
+void TestInventory::outputs()
+{
+    const ScreenInventory inventory = InventoryParseXrandrVerbose(RecordedOutput());
+    QCOMPARE(inventory.outputs.count(), 3);
+    QCOMPARE(InventoryConnectedOutputs(inventory).count(), 2);
+
+    const OutputInfo &internal = inventory.outputs.at(0);
+    QCOMPARE(internal.name, QString("eDP-1"));
+    QVERIFY(internal.connected);
+    QVERIFY(internal.primary);
+    QCOMPARE(internal.geometry, QRect(0, 0, 2880, 1620));
+    QCOMPARE(internal.rotation, QString("normal"));
+    QCOMPARE(internal.panning, QRect(0, 0, 2880, 1620));
+    QCOMPARE(internal.transform,
+             QList<qreal>({1.5, 0, 0, 0, 1.5, 0, 0, 0, 1}));
+    QCOMPARE(internal.crtcs, QList<int>({0, 1, 2}));
+    QCOMPARE(internal.physicalSize, QSize(344, 194));
+    QCOMPARE(internal.edid, TestMakeEdid("Internal", 34, 19));
+
+    // Physical size is read from the EDID if xrandr reports 0mm x 0mm
+    const OutputInfo &external = inventory.outputs.at(1);
+    QCOMPARE(external.name, QString("HDMI-1"));
+    QVERIFY(external.connected);
+    QVERIFY(!external.primary);
+    QCOMPARE(external.geometry, QRect(2880, 0, 1080, 1920));
+    QCOMPARE(external.rotation, QString("left"));
+    QVERIFY(external.panning.isEmpty());
+    QCOMPARE(external.crtcs, QList<int>({1, 2}));
+    QCOMPARE(external.physicalSize, QSize(600, 340));
+    QCOMPARE(external.edid, TestMakeEdid("External"));
+
+    const OutputInfo &empty = inventory.outputs.at(2);
+    QCOMPARE(empty.name, QString("DP-1"));
+    QVERIFY(!empty.connected);
+    QVERIFY(!empty.geometry.isValid());
+    QVERIFY(empty.rotation.isEmpty());
+    QVERIFY(empty.edid.isEmpty());
+    QVERIFY(empty.modes.isEmpty());
+    QCOMPARE(empty.crtcs, QList<int>({0, 1, 2}));
+}
+
+/**
+ * Modes are registered with their pixel clock, refresh rate and flags
+ */
+void TestInventory::modes()
+{
+    const ScreenInventory inventory = InventoryParseXrandrVerbose(RecordedOutput());
+    const OutputInfo &internal = inventory.outputs.at(0);
+    QCOMPARE(internal.modes.count(), 3);
+    QCOMPARE(InventoryResolutions(internal), QStringList({"1920x1080", "1280x720"}));
+
+    const ModeInfo &native = internal.modes.at(0);
+    QCOMPARE(native.name, QString("1920x1080"));
+    QCOMPARE(native.id, QString("0x48"));
+    QCOMPARE(native.size, QSize(1920, 1080));
+    QCOMPARE(native.pixelClock, 138.5);
+    QCOMPARE(native.refresh, 59.93);
+    QVERIFY(native.current);
+    QVERIFY(native.preferred);
+
+    const ModeInfo &slow = internal.modes.at(1);
+    QCOMPARE(slow.id, QString("0x49"));
+    QCOMPARE(slow.refresh, 47.98);
+    QVERIFY(!slow.current);
+    QVERIFY(!slow.preferred);
+
+    QCOMPARE(InventoryPreferredMode(internal).id, QString("0x48"));
+    QCOMPARE(InventoryPreferredMode(inventory.outputs.at(1)).refresh, 60.0);
+    QCOMPARE(InventoryPreferredMode(inventory.outputs.at(2)).id, QString());
+}
+
+/**
+ * An EDID at the end of the output is not lost
+ */
+void TestInventory::trailingEdid()
+{
+    const QString output = QString("Screen 0: minimum 8 x 8, current 1920 x 1080, "
+                                   "maximum 32767 x 32767\n"
+                                   "HDMI-1 connected 1920x1080+0+0 (0x4b) normal "
+                                   "(normal left inverted right x axis y axis) 0mm "
+                                   "x 0mm\n%1")
+                               .arg(EdidProperty(TestMakeEdid("External")));
+
+    const ScreenInventory inventory = InventoryParseXrandrVerbose(output);
+    QCOMPARE(inventory.outputs.count(), 1);
+    QCOMPARE(inventory.outputs.at(0).edid, TestMakeEdid("External"));
+    QCOMPARE(inventory.outputs.at(0).physicalSize, QSize(600, 340));
+}
+
+/**
+ * Inventories read back from JSON are identical to the original ones
+ */
+void TestInventory::jsonRoundTrip()
+{
+    const ScreenInventory inventory = InventoryParseXrandrVerbose(RecordedOutput());
+    const QJsonObject json = InventoryToJson(inventory);
+    const ScreenInventory copy = InventoryFromJson(json);
+    QCOMPARE(InventoryToJson(copy), json);
+
+    QCOMPARE(copy.maximum, inventory.maximum);
+    QCOMPARE(copy.outputs.count(), 3);
+    QCOMPARE(copy.outputs.at(0).edid, inventory.outputs.at(0).edid);
+    QCOMPARE(copy.outputs.at(0).panning, inventory.outputs.at(0).panning);
+    QCOMPARE(copy.outputs.at(0).transform, inventory.outputs.at(0).transform);
+    QCOMPARE(copy.outputs.at(1).rotation, QString("left"));
+    QCOMPARE(copy.outputs.at(1).modes.at(0).refresh, 60.0);
+    QCOMPARE(ProfileFingerprint(copy), ProfileFingerprint(inventory));
+}
+
+/**
+ * The fingerprint only depends on the connected outputs and their EDIDs,
+ * not on their order or on the layout that is currently applied
+ */
+void TestInventory::fingerprint()
+{
+    const ScreenInventory inventory = InventoryParseXrandrVerbose(RecordedOutput());
+    const QString fingerprint = ProfileFingerprint(inventory);
+    QCOMPARE(fingerprint.length(), 16);
+    QVERIFY(QRegExp("[0-9a-f]+").exactMatch(fingerprint));
+
+    // Order of the outputs
+    ScreenInventory reordered = inventory;
+    reordered.outputs.swapItemsAt(0, 2);
+    QCOMPARE(ProfileFingerprint(reordered), fingerprint);
+
+    // Layout changes
+    ScreenInventory applied = inventory;
+    applied.current = QSize(3840, 1080);
+    applied.outputs[0].geometry = QRect(0, 0, 1920, 1080);
+    applied.outputs[0].transform.clear();
+    applied.outputs[1].rotation = "normal";
+    applied.outputs[1].modes[0].current = false;
+    QCOMPARE(ProfileFingerprint(applied), fingerprint);
+
+    // Connected outputs without modes are ignored
+    ScreenInventory empty = inventory;
+    empty.outputs[2].connected = true;
+    QCOMPARE(ProfileFingerprint(empty), fingerprint);
+
+    // Nothing connected
+    ScreenInventory headless = inventory;
+    headless.outputs[0].connected = false;
+    headless.outputs[1].connected = false;
+    QVERIFY(ProfileFingerprint(headless).isEmpty());
+    QVERIFY(ProfileFingerprint(ScreenInventory()).isEmpty());
+}
+
+/**
+ * Plugging another monitor (or the same one in another port) gives another
+ * fingerprint
+ */
+void TestInventory::fingerprintChanges()
+{
+    const ScreenInventory inventory = InventoryParseXrandrVerbose(RecordedOutput());
+    const QString fingerprint = ProfileFingerprint(inventory);
+
+    ScreenInventory monitor = inventory;
+    monitor.outputs[1].edid = TestMakeEdid("Projector");
+    QVERIFY(ProfileFingerprint(monitor) != fingerprint);
+
+    ScreenInventory port = inventory;
+    port.outputs[1].name = "HDMI-2";
+    QVERIFY(ProfileFingerprint(port) != fingerprint);
+
+    ScreenInventory unplugged = inventory;
+    unplugged.outputs[1].connected = false;
+    QVERIFY(ProfileFingerprint(unplugged) != fingerprint);
+}
+
+/**
+ * Profiles are named after their outputs and the monitor names in the EDIDs
+ */
+void TestInventory::describe()
+{
+    ScreenInventory inventory = InventoryParseXrandrVerbose(RecordedOutput());
+    ProfileInfo info = ProfileDescribe(inventory);
+    QCOMPARE(info.fingerprint, ProfileFingerprint(inventory));
+    QCOMPARE(info.name, QString("eDP-1 (Internal) + HDMI-1 (External)"));
+    QCOMPARE(info.outputs, QStringList({"eDP-1", "HDMI-1"}));
+    QCOMPARE(info.monitors, QStringList({"Internal", "External"}));
+
+    inventory.outputs[1].edid.clear();
+    info = ProfileDescribe(inventory);
+    QCOMPARE(info.name, QString("eDP-1 (Internal) + HDMI-1"));
+    QCOMPARE(info.monitors, QStringList({"Internal", QString()}));
+}
+
+QTEST_APPLESS_MAIN(TestInventory)
+
+#include "tst_Inventory.moc"
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QtTest>
+
+#include "PowerSupply.h"
+
+/**
+ * Creates a fake power supply called @a name in @a path with the given sysfs
+ * @a attributes
+ */
+static void AddSupply(const QString &path, const QString &name,
+                      const QMap<QString, QString> &attributes)
+{
+    QDir dir(path);
+    QVERIFY(dir.mkpath(name));
+
+    for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it)
+    {
+        QFile file(dir.filePath(name + "/" + it.key()));
+        QVERIFY(file.open(QFile::WriteOnly));
+        file.write(it.value().toLatin1() + "\n");
+        file.close();
+    }
+}
+
+/**
+ * Checks the power source detected from fake /sys/class/power_supply trees
+ */
+class TestPower : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void source_data();
+    void source();
+    void missingDirectory();
+};
+
+void TestPower::source_data()
+{
+    QTest::addColumn<QStringList>("supplies");
+    QTest::addColumn<int>("expected");
+
+    // Each supply is given as <name>,<type>,<online or status>[,<scope>]
+    QTest::newRow("laptop on AC")
+        << QStringList({"AC,Mains,1", "BAT0,Battery,Charging"}) << int(PowerAc);
+    QTest::newRow("laptop full on AC")
+        << QStringList({"AC,Mains,1", "BAT0,Battery,Full"}) << int(PowerAc);
+    QTest::newRow("laptop on battery")
+        << QStringList({"AC,Mains,0", "BAT0,Battery,Discharging"}) << int(PowerBattery);
+    QTest::newRow("laptop unplugged, battery not charging")
+        << QStringList({"AC,Mains,0", "BAT0,Battery,Not charging"}) << int(PowerBattery);
+    QTest::newRow("laptop charged through USB-C")
+        << QStringList({"AC,Mains,0", "ucsi-source-psy-USBC000:001,USB,1",
+                        "BAT0,Battery,Charging"})
+        << int(PowerAc);
+    QTest::newRow("USB-C laptop with empty port")
+        << QStringList({"ucsi-source-psy-USBC000:001,USB,0", "BAT0,Battery,Full"})
+        << int(PowerAc);
+    QTest::newRow("USB-C laptop on battery")
+        << QStringList({"ucsi-source-psy-USBC000:001,USB,0",
+                        "BAT0,Battery,Discharging"})
+        << int(PowerBattery);
+    QTest::newRow("desktop") << QStringList({"AC,Mains,1"}) << int(PowerAc);
+    QTest::newRow("desktop with empty USB-C port")
+        << QStringList({"ucsi-source-psy-USBC000:001,USB,0"}) << int(PowerUnknown);
+    QTest::newRow("desktop with wireless mouse")
+        << QStringList({"ucsi-source-psy-USBC000:001,USB,0",
+                        "hidpp_battery_0,Battery,Discharging,Device"})
+        << int(PowerUnknown);
+    QTest::newRow("no supplies") << QStringList() << int(PowerUnknown);
+}
+
+/**
+ * Machines only run on battery if they have a system battery, offline USB-C
+ * ports and peripheral batteries are ignored
+ */
+void TestPower::source()
+{
+    QFETCH(QStringList, supplies);
+    QFETCH(int, expected);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    for (int i = 0; i < supplies.count(); ++i)
+    {
+        const QStringList fields = supplies.at(i).split(',');
+
+        QMap<QString, QString> attributes;
+        attributes.insert("type", fields.at(1));
+        if (fields.at(1) == "Battery")
+            attributes.insert("status", fields.at(2));
+        else
+            attributes.insert("online", fields.at(2));
+        if (fields.count() > 3)
+            attributes.insert("scope", fields.at(3));
+
+        AddSupply(dir.path(), fields.at(0), attributes);
+    }
+
+    QCOMPARE(int(PowerGetSource(dir.path())), expected);
+}
+
+/**
+ * Machines without /sys/class/power_supply have an unknown power source
+ */
+void TestPower::missingDirectory()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QCOMPARE(PowerGetSource(dir.filePath("missing")), PowerUnknown);
+    QCOMPARE(PowerSourceName(PowerUnknown), QString("unknown"));
+    QCOMPARE(PowerSourceName(PowerBattery), QString("battery"));
+    QCOMPARE(PowerSourceName(PowerAc), QString("AC"));
+}
+
+QTEST_APPLESS_MAIN(TestPower)
+
+#include "tst_Power.moc"
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QtTest>
+
+#include "Edid.h"
+#include "TestEdid.h"
+#include "Preflight.h"
+
+/**
+ * Returns a mode of @a width x @a height at @a refresh Hz
+ */
+static ModeInfo MakeMode(const int width, const int height, const qreal refresh,
+                         const qreal pixelClock)
+{
+    ModeInfo mode;
+    mode.name = QString("%1x%2").arg(width).arg(height);
+    mode.size = QSize(width, height);
+    mode.refresh = refresh;
+    mode.pixelClock = pixelClock;
+    return mode;
+}
+
+/**
+ * Returns a connected 1080p output at @a geometry that can be driven by the
+ * given @a crtcs and reports the given @a edid
+ */
+static OutputInfo MakeOutput(const QString &name, const QRect &geometry,
+                             const QList<int> &crtcs, const QByteArray &edid)
+{
+    OutputInfo output;
+    output.name = name;
+    output.connected = true;
+    output.geometry = geometry;
+    output.crtcs = crtcs;
+    output.edid = edid;
+    output.modes.append(MakeMode(1920, 1080, 60, 148.5));
+    output.modes.append(MakeMode(1920, 1080, 50, 148.5));
+    output.modes.append(MakeMode(1280, 720, 60, 74.25));
+    return output;
+}
+
+/**
+ * Returns the inventory of a laptop (eDP-1) with an external monitor at its
+ * right (HDMI-1) and an empty DisplayPort (DP-1)
+ */
+static ScreenInventory MakeInventory()
+{
+    OutputInfo empty;
+    empty.name = "DP-1";
+    empty.crtcs = {0, 1};
+
+    ScreenInventory inventory;
+    inventory.minimum = QSize(320, 200);
+    inventory.current = QSize(3840, 1080);
+    inventory.maximum = QSize(8192, 8192);
+    inventory.outputs.append(MakeOutput("eDP-1", QRect(0, 0, 1920, 1080), {0, 1},
+                                        TestMakeEdid("Internal")));
+    inventory.outputs.append(MakeOutput("HDMI-1", QRect(1920, 0, 1920, 1080), {0, 1},
+                                        TestMakeEdid("External")));
+    inventory.outputs.append(empty);
+    return inventory;
+}
+
+/**
+ * Returns a display of the given @a name that uses the 1080p mode at @a scale
+ */
+static DisplayConfig MakeDisplay(const QString &name, const qreal scale)
+{
+    DisplayConfig display;
+    display.name = name;
+    display.mode = QSize(1920, 1080);
+    display.scale = scale;
+    return display;
+}
+
+/**
+ * Returns @c true if one of the @a errors contains the given @a text
+ */
+static bool HasError(const QStringList &errors, const QString &text)
+{
+    for (int i = 0; i < errors.count(); ++i)
+    {
+        if (errors.at(i).contains(text))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Checks the EDID range limits parser and the checks that are done before a
+ * layout is applied against recorded inventories
+ */
+class TestPreflight : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rangeLimits();
+    void rangeLimitOffsets_data();
+    void rangeLimitOffsets();
+    void invalidEdid();
+    void validLayout();
+    void framebufferLimit();
+    void incompleteFramebuffer();
+    void scaleModes_data();
+    void scaleModes();
+    void timingLimits();
+    void crtcAssignment();
+    void disconnectedOutput();
+};
+
+/**
+ * The range limits descriptor is found and read as is
+ */
+void TestPreflight::rangeLimits()
+{
+    const QByteArray edid = TestMakeEdid("Monitor");
+    QVERIFY(EdidIsValid(edid));
+    QCOMPARE(EdidGetMonitorName(edid), QString("Monitor"));
+    QCOMPARE(EdidGetPhysicalSize(edid), QSize(600, 340));
+
+    const EdidRangeLimits limits = EdidGetRangeLimits(edid);
+    QVERIFY(limits.valid);
+    QCOMPARE(limits.minVRate, 48);
+    QCOMPARE(limits.maxVRate, 75);
+    QCOMPARE(limits.minHRate, 30);
+    QCOMPARE(limits.maxHRate, 160);
+    QCOMPARE(limits.maxPixelClock, 600);
+}
+
+void TestPreflight::rangeLimitOffsets_data()
+{
+    QTest::addColumn<int>("flags");
+    QTest::addColumn<int>("minVRate");
+    QTest::addColumn<int>("maxVRate");
+    QTest::addColumn<int>("minHRate");
+    QTest::addColumn<int>("maxHRate");
+
+    QTest::newRow("none") << 0x00 << 1 << 5 << 2 << 10;
+    QTest::newRow("maximum rates") << 0x0a << 1 << 260 << 2 << 265;
+    QTest::newRow("all rates") << 0x0f << 256 << 260 << 257 << 265;
+}
+
+/**
+ * EDID 1.4 displays add 255 to the rates whose offset flags are set
+ */
+void TestPreflight::rangeLimitOffsets()
+{
+    QFETCH(int, flags);
+    QFETCH(int, minVRate);
+    QFETCH(int, maxVRate);
+    QFETCH(int, minHRate);
+    QFETCH(int, maxHRate);
+
+    TestRangeLimits raw;
+    raw.flags = flags;
+    raw.minVRate = 1;
+    raw.maxVRate = 5;
+    raw.minHRate = 2;
+    raw.maxHRate = 10;
+
+    const QByteArray edid = TestMakeEdid("Monitor", 60, 34, raw);
+    const EdidRangeLimits limits = EdidGetRangeLimits(edid);
+    QVERIFY(limits.valid);
+    QCOMPARE(limits.minVRate, minVRate);
+    QCOMPARE(limits.maxVRate, maxVRate);
+    QCOMPARE(limits.minHRate, minHRate);
+    QCOMPARE(limits.maxHRate, maxHRate);
+}
+
+/**
+ * Corrupted or truncated EDIDs and EDIDs without range limits give no limits
+ */
+void TestPreflight::invalidEdid()
+{
+    QByteArray corrupted = TestMakeEdid("Monitor");
+    corrupted[127] = static_cast<char>(corrupted.at(127) + 1);
+    QVERIFY(!EdidIsValid(corrupted));
+    QVERIFY(!EdidGetRangeLimits(corrupted).valid);
+    QVERIFY(EdidGetMonitorName(corrupted).isEmpty());
+
+    QVERIFY(!EdidGetRangeLimits(TestMakeEdid("Monitor").left(100)).valid);
+    QVERIFY(!EdidGetRangeLimits(QByteArray()).valid);
+
+    const QByteArray edid = TestMakeEdid("Monitor", 60, 34, TestRangeLimits(), false);
+    QVERIFY(EdidIsValid(edid));
+    QVERIFY(!EdidGetRangeLimits(edid).valid);
+}
+
+/**
+ * Layouts that the displays support pass with both scaling methods
+ */
+void TestPreflight::validLayout()
+{
+    const ScreenInventory inventory = MakeInventory();
+    const DisplayLayout layout = LayoutCompute(
+        {MakeDisplay("eDP-1", 1), MakeDisplay("HDMI-1", 1)}, inventory.maximum);
+
+    QCOMPARE(PreflightValidate(layout, inventory, false), QStringList());
+    QCOMPARE(PreflightValidate(layout, inventory, true), QStringList());
+}
+
+/**
+ * The framebuffer of a layout cannot exceed the maximum screen size
+ */
+void TestPreflight::framebufferLimit()
+{
+    ScreenInventory inventory = MakeInventory();
+    inventory.maximum = QSize(3000, 3000);
+
+    const DisplayLayout layout = LayoutCompute(
+        {MakeDisplay("eDP-1", 1), MakeDisplay("HDMI-1", 2)}, QSize());
+    QVERIFY(HasError(PreflightValidate(layout, inventory, false),
+                     "exceeds the maximum screen size 3000x3000"));
+}
+
+/**
+ * An incomplete layout is checked against the framebuffer it needs once the
+ * displays that it leaves untouched are taken into account, not against its
+ * own framebuffer
+ */
+void TestPreflight::incompleteFramebuffer()
+{
+    ScreenInventory inventory = MakeInventory();
+    inventory.maximum = QSize(4096, 4096);
+
+    DisplayLayout layout = LayoutCompute({MakeDisplay("HDMI-1", 1.5)}, QSize());
+    QCOMPARE(layout.framebuffer, QSize(2560, 1440));
+    QCOMPARE(PreflightValidate(layout, inventory, false), QStringList());
+
+    // HDMI-1 keeps its position at the right of eDP-1
+    layout.complete = false;
+    QCOMPARE(PreflightValidate(layout, inventory, false),
+             QStringList("Framebuffer 4480x1440 exceeds the maximum screen size "
+                         "4096x4096"));
+
+    // HDMI-1 is off, it is placed at the right of the screen
+    inventory.current = QSize(1920, 1080);
+    inventory.outputs[1].geometry = QRect();
+    QCOMPARE(PreflightValidate(layout, inventory, false),
+             QStringList("Framebuffer 4480x1440 exceeds the maximum screen size "
+                         "4096x4096"));
+}
+
+void TestPreflight::scaleModes_data()
+{
+    QTest::addColumn<QSize>("mode");
+    QTest::addColumn<qreal>("refresh");
+    QTest::addColumn<QString>("error");
+
+    QTest::newRow("any rate") << QSize(1920, 1080) << 0.0 << QString();
+    QTest::newRow("second rate") << QSize(1920, 1080) << 50.0 << QString();
+    QTest::newRow("rounded rate") << QSize(1280, 720) << 59.94 << QString();
+    QTest::newRow("unsupported rate")
+        << QSize(1920, 1080) << 75.0
+        << QString("HDMI-1: mode 1920x1080 is not supported at 75 Hz");
+    QTest::newRow("unsupported mode")
+        << QSize(2560, 1440) << 0.0
+        << QString("HDMI-1: mode 2560x1440 is not supported");
+}
+
+/**
+ * With xrandr --scale the output must support the requested mode and
+ * refresh rate of the display
+ */
+void TestPreflight::scaleModes()
+{
+    QFETCH(QSize, mode);
+    QFETCH(qreal, refresh);
+    QFETCH(QString, error);
+
+    DisplayConfig display = MakeDisplay("HDMI-1", 2);
+    display.mode = mode;
+    display.refresh = refresh;
+
+    const DisplayLayout layout = LayoutCompute({display}, QSize());
+    const QStringList errors = PreflightValidate(layout, MakeInventory(), true);
+    if (error.isEmpty())
+        QCOMPARE(errors, QStringList());
+    else
+        QCOMPARE(errors, QStringList(error));
+}
+
+/**
+ * Custom modes must respect the pixel clock and the timing ranges of the
+ * EDID of their display
+ */
+void TestPreflight::timingLimits()
+{
+    ScreenInventory inventory = MakeInventory();
+
+    // 3840x2160 custom mode needs a pixel clock of 712.75 MHz
+    DisplayLayout layout = LayoutCompute(
+        {MakeDisplay("eDP-1", 1), MakeDisplay("HDMI-1", 2)}, QSize());
+    QCOMPARE(PreflightValidate(layout, inventory, false),
+             QStringList("eDP-1: pixel clock of 712.75 MHz exceeds the maximum of "
+                         "600 MHz"));
+
+    // The same layout with xrandr --scale uses the 148.50 MHz native mode
+    QCOMPARE(PreflightValidate(layout, inventory, true), QStringList());
+
+    // 1920x1080 at 60 Hz has a horizontal rate of 67.16 kHz
+    TestRangeLimits limits;
+    limits.maxVRate = 50;
+    limits.maxHRate = 60;
+    inventory.outputs[1].edid = TestMakeEdid("External", 60, 34, limits);
+    layout = LayoutCompute({MakeDisplay("HDMI-1", 1)}, QSize());
+    const QStringList errors = PreflightValidate(layout, inventory, false);
+    QCOMPARE(errors.count(), 2);
+    QVERIFY(HasError(errors, "HDMI-1: horizontal rate of 67.16 kHz is outside"));
+    QVERIFY(HasError(errors, "HDMI-1: refresh rate of"));
+}
+
+/**
+ * Each display needs its own CRTC, which may require moving other displays
+ * to another CRTC
+ */
+void TestPreflight::crtcAssignment()
+{
+    ScreenInventory inventory = MakeInventory();
+    const DisplayLayout layout = LayoutCompute(
+        {MakeDisplay("eDP-1", 1), MakeDisplay("HDMI-1", 1)}, QSize());
+
+    inventory.outputs[1].crtcs = {0};
+    QCOMPARE(PreflightValidate(layout, inventory, false), QStringList());
+
+    inventory.outputs[0].crtcs = {0};
+    QCOMPARE(PreflightValidate(layout, inventory, false),
+             QStringList("Not enough CRTCs to drive 2 displays"));
+
+    // CRTCs are not checked if the inventory does not report them
+    inventory.outputs[0].crtcs.clear();
+    QCOMPARE(PreflightValidate(layout, inventory, false), QStringList());
+}
+
+/**
+ * Displays that are not connected (or do not exist) are reported
+ */
+void TestPreflight::disconnectedOutput()
+{
+    const DisplayLayout layout = LayoutCompute(
+        {MakeDisplay("eDP-1", 1), MakeDisplay("DP-1", 1), MakeDisplay("VGA-1", 1)},
+        QSize());
+
+    QCOMPARE(PreflightValidate(layout, MakeInventory(), false),
+             QStringList({"DP-1: output is not connected",
+                          "VGA-1: output is not connected"}));
+}
+
+QTEST_APPLESS_MAIN(TestPreflight)
+
+#include "tst_Preflight.moc"
@@ -0,0 +1,136 @@
+#!/bin/bash
+#
+# Copyright (c) 2018 Alex Spataru <https://github.com/alex-spataru>
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+
+#
+# Starts several Xvfb servers and validates all of them at once with
+# "hidpi-fixer-cli --sessions", which probes each display from its own worker
+# thread. Each display must be reported, and must get its own recording
+# (HIDPI_FIXER_BACKEND=record:<file>), which is then played back again.
+#
+# The displays are then scaled for real (2x, with custom modes) and set back
+# to scale 1, checking the screen size, the current mode and the font DPI and
+# cursor size X resources of each display after both runs.
+#
+# Usage: tests/sessions/xvfb-sessions.sh [hidpi-fixer-cli] [number of servers]
+#
+
+set -eu
+
+CLI=${1:-./hidpi-fixer-cli}
+COUNT=${2:-4}
+FIRST_DISPLAY=91
+WORK=$(mktemp -d)
+PIDS=()
+DISPLAYS=()
+
+cleanup() {
+    [ ${#PIDS[@]} -gt 0 ] && kill "${PIDS[@]}" 2>/dev/null
+    rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+# Start X servers
+for ((i = 0; i < COUNT; ++i)); do
+    display=":$((FIRST_DISPLAY + i))"
+    Xvfb "$display" -screen 0 1920x1080x24 -nolisten tcp >/dev/null 2>&1 &
+    PIDS+=($!)
+    DISPLAYS+=("$display")
+done
+
+# Wait until every server accepts connections
+for display in "${DISPLAYS[@]}"; do
+    for ((try = 0; try < 50; ++try)); do
+        [ -S "/tmp/.X11-unix/X${display#:}" ] && break
+        sleep 0.1
+    done
+done
+
+# Validate every display concurrently (two at a time), recording each one
+HIDPI_FIXER_BACKEND="record:$WORK/session.json" \
+    "$CLI" --sessions "${DISPLAYS[@]}" --jobs 2 --dry-run --report "$WORK/report.json"
+
+# Play the recordings back
+HIDPI_FIXER_BACKEND="replay:$WORK/session.json" \
+    "$CLI" --sessions "${DISPLAYS[@]}" --jobs 2 --dry-run --report "$WORK/replay.json"
+
+# Scale every display to 2x with custom modes, then undo it
+for run in apply:2 revert:1; do
+    HIDPI_FIXER_BACKEND=native "$CLI" --sessions "${DISPLAYS[@]}" --jobs 2 \
+        --scale "${run#*:}" --method mode --report "$WORK/${run%:*}.json"
+
+    for display in "${DISPLAYS[@]}"; do
+        xrandr --display "$display" >"$WORK/${run%:*}.xrandr.${display#:}"
+        xrdb -display "$display" -query >"$WORK/${run%:*}.xrdb.${display#:}"
+    done
+done
+
+# Check the reports, the recordings and the state of each X screen
+python3 - "$WORK" "${DISPLAYS[@]}" <<'CHECK'
+import json
+import os
+import sys
+
+work, displays = sys.argv[1], sys.argv[2:]
+for name in ("report.json", "replay.json"):
+    with open(os.path.join(work, name)) as file:
+        report = json.load(file)
+
+    assert report["total"] == len(displays), report
+    assert report["failed"] == 0, report
+    reported = sorted(entry["display"] for entry in report["displays"])
+    assert reported == sorted(displays), reported
+
+for display in displays:
+    with open(os.path.join(work, "session.json." + display.lstrip(":"))) as file:
+        lines = [json.loads(line) for line in file if line.strip()]
+
+    assert "backend" in lines[0], display
+    assert [line["call"] for line in lines[1:]] == ["inventory"], display
+
+# Custom 2x modes and X resources are applied, then removed by the 1x run
+expected = {
+    "apply": ("1920x1080_60.00", {"Xft.dpi": "192", "Xcursor.size": "48"}),
+    "revert": ("1920x1080", {}),
+}
+for run, (mode, resources) in expected.items():
+    with open(os.path.join(work, run + ".json")) as file:
+        report = json.load(file)
+
+    assert report["failed"] == 0, report
+    for display in displays:
+        suffix = "." + display.lstrip(":")
+        with open(os.path.join(work, run + ".xrandr" + suffix)) as file:
+            lines = file.read().splitlines()
+        with open(os.path.join(work, run + ".xrdb" + suffix)) as file:
+            query = dict(line.split(":", 1) for line in file if ":" in line)
+
+        assert "current 1920 x 1080," in lines[0], (run, display, lines[0])
+        current = [line.split()[0] for line in lines if "*" in line]
+        assert current == [mode], (run, display, current)
+        found = {key: query[key].strip() for key in ("Xft.dpi", "Xcursor.size")
+                 if key in query}
+        assert found == resources, (run, display, found)
+
+print("Validated and scaled %d X displays concurrently" % len(displays))
+CHECK